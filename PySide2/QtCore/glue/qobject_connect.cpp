@@ -47,6 +47,15 @@ static bool getReceiver(QObject *source, const char* signal, PyObject* callback,
     return usingGlobalReceiver;
 }
 
+// Methods added by Python classes live on the dynamic part of the metaobject
+static bool isPythonMethod(QObject* receiver, const char* method, bool isSignal)
+{
+    const QMetaObject* metaObject = receiver->metaObject();
+    QByteArray signature = QMetaObject::normalizedSignature(method);
+    int index = isSignal ? metaObject->indexOfSignal(signature) : metaObject->indexOfSlot(signature);
+    return index >= metaObject->methodOffset();
+}
+
 static bool qobjectConnect(QObject* source, const char* signal, QObject* receiver, const char* slot, Qt::ConnectionType type)
 {
     if (!signal || !slot)
@@ -66,6 +75,8 @@ static bool qobjectConnect(QObject* source, const char* signal, QObject* receive
     Py_BEGIN_ALLOW_THREADS
     connection = QObject::connect(source, signal - 1, receiver, slot - 1, type);
     Py_END_ALLOW_THREADS
+    if (connection && isPythonMethod(receiver, slot, isSignal))
+        PySide::SignalManager::addPythonReceiver(source, source->metaObject()->indexOfSignal(QMetaObject::normalizedSignature(signal)));
     return connection;
 }
 
@@ -127,6 +138,8 @@ static bool qobjectConnectCallback(QObject* source, const char* signal, PyObject
     if (connection) {
         if (usingGlobalReceiver)
             signalManager.notifyGlobalReceiver(receiver);
+        if (usingGlobalReceiver || slotIndex >= metaObject->methodOffset())
+            PySide::SignalManager::addPythonReceiver(source, signalIndex);
         #ifndef AVOID_PROTECTED_HACK
             source->connectNotify(signalMethod); //Qt5: QMetaMethod instead of char*
         #else
@@ -151,6 +164,8 @@ static bool qobjectDisconnectCallback(QObject* source, const char* signal, PyObj
         return false;
 
     PySide::SignalManager& signalManager = PySide::SignalManager::instance();
+    if (signalManager.disconnectCoalesced(source, source->metaObject()->indexOfSignal(signal + 1), callback))
+        return true;
 
     // Extract receiver from callback
     QObject* receiver = 0;
@@ -165,7 +180,11 @@ static bool qobjectDisconnectCallback(QObject* source, const char* signal, PyObj
     int signalIndex = source->metaObject()->indexOfSignal(++signal);
     int slotIndex = -1;
 
-    slotIndex = metaObject->indexOfSlot(callbackSig);
+    // the encoded callback name is not a slot of the shared table, -1 would match any slot
+    if (usingGlobalReceiver)
+        slotIndex = signalManager.globalReceiverSlotIndex(receiver, callbackSig);
+    else
+        slotIndex = metaObject->indexOfSlot(callbackSig);
     slotMethod = metaObject->method(slotIndex);
 
     bool disconnected;
@@ -174,6 +193,8 @@ static bool qobjectDisconnectCallback(QObject* source, const char* signal, PyObj
     Py_END_ALLOW_THREADS
 
     if (disconnected) {
+        if (usingGlobalReceiver || slotIndex >= metaObject->methodOffset())
+            PySide::SignalManager::removePythonReceiver(source, signalIndex);
         if (usingGlobalReceiver)
             signalManager.releaseGlobalReceiver(source, receiver);
 
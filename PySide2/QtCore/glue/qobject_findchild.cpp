@@ -1,22 +1,66 @@
-static QObject* _findChildHelper(const QObject* parent, const QString& name, PyTypeObject* desiredType)
+// Returns the metaobject that every instance of desiredType has in its class hierarchy, 0 if
+// the type isn't a QObject one. Children not inheriting it can be skipped without wrapping them.
+static const QMetaObject* _findChildMetaObject(PyTypeObject* desiredType)
+{
+    static PyTypeObject* qObjectType = Shiboken::Conversions::getPythonTypeObject("QObject*");
+    static PyTypeObject* qMetaObjectType = Shiboken::Conversions::getPythonTypeObject("QMetaObject*");
+    if (!PyType_IsSubtype(desiredType, qObjectType))
+        return 0;
+
+    Shiboken::AutoDecRef pyMetaObject(PyObject_GetAttrString(reinterpret_cast<PyObject*>(desiredType), "staticMetaObject"));
+    if (pyMetaObject.isNull()) {
+        PyErr_Clear();
+        return 0;
+    }
+    if (!PyObject_TypeCheck(pyMetaObject.object(), qMetaObjectType))
+        return 0;
+    return %CONVERTTOCPP[QMetaObject*](pyMetaObject);
+}
+
+static inline bool _findChildInherits(const QObject* child, const QMetaObject* metaObject)
+{
+    if (!metaObject)
+        return true;
+    for (const QMetaObject* mo = child->metaObject(); mo; mo = mo->superClass()) {
+        if (mo == metaObject)
+            return true;
+    }
+    return false;
+}
+
+// The Python type of a wrapper may be more specific than its metaobject, so the type is
+// checked again on the wrappers of the children which passed the metaobject check
+static inline bool _findChildMatches(const QObject* child, const QMetaObject* metaObject, PyTypeObject* desiredType)
+{
+    if (!_findChildInherits(child, metaObject))
+        return false;
+    Shiboken::AutoDecRef pyChild(%CONVERTTOPYTHON[QObject*](child));
+    return PyType_IsSubtype(pyChild->ob_type, desiredType);
+}
+
+static QObject* _findChildHelper(const QObject* parent, const QString& name, PyTypeObject* desiredType, const QMetaObject* metaObject)
 {
     foreach(QObject* child, parent->children()) {
-        Shiboken::AutoDecRef pyChild(%CONVERTTOPYTHON[QObject*](child));
-        if (PyType_IsSubtype(pyChild->ob_type, desiredType)
-            && (name.isNull() || name == child->objectName())) {
+        if ((name.isNull() || name == child->objectName())
+            && _findChildMatches(child, metaObject, desiredType)) {
             return child;
         }
     }
 
     QObject* obj;
     foreach(QObject* child, parent->children()) {
-        obj = _findChildHelper(child, name, desiredType);
+        obj = _findChildHelper(child, name, desiredType, metaObject);
         if (obj)
             return obj;
     }
     return 0;
 }
 
+static inline QObject* _findChildHelper(const QObject* parent, const QString& name, PyTypeObject* desiredType)
+{
+    return _findChildHelper(parent, name, desiredType, _findChildMetaObject(desiredType));
+}
+
 static inline bool _findChildrenComparator(const QObject*& child, const QRegExp& name)
 {
     return name.indexIn(child->objectName()) != -1;
@@ -28,12 +72,148 @@ static inline bool _findChildrenComparator(const QObject*& child, const QString&
 }
 
 template<typename T>
-static void _findChildrenHelper(const QObject* parent, const T& name, PyTypeObject* desiredType, PyObject* result)
+static void _findChildrenHelper(const QObject* parent, const T& name, PyTypeObject* desiredType, const QMetaObject* metaObject, PyObject* result)
 {
     foreach(const QObject* child, parent->children()) {
-        Shiboken::AutoDecRef pyChild(%CONVERTTOPYTHON[QObject*](child));
-        if (PyType_IsSubtype(pyChild->ob_type, desiredType) && _findChildrenComparator(child, name))
-            PyList_Append(result, pyChild);
-        _findChildrenHelper(child, name, desiredType, result);
+        if (_findChildrenComparator(child, name) && _findChildInherits(child, metaObject)) {
+            Shiboken::AutoDecRef pyChild(%CONVERTTOPYTHON[QObject*](child));
+            if (PyType_IsSubtype(pyChild->ob_type, desiredType))
+                PyList_Append(result, pyChild);
+        }
+        _findChildrenHelper(child, name, desiredType, metaObject, result);
     }
 }
+
+template<typename T>
+static inline void _findChildrenHelper(const QObject* parent, const T& name, PyTypeObject* desiredType, PyObject* result)
+{
+    _findChildrenHelper(parent, name, desiredType, _findChildMetaObject(desiredType), result);
+}
+
+// Iterator returned by findChildrenIter(), it walks the children in the same order as
+// findChildren() but only wraps a child when it is requested.
+extern "C"
+{
+
+struct FindChildrenIterator
+{
+    PyObject_HEAD
+    PyObject* pyParent;
+    PyTypeObject* desiredType;
+    const QMetaObject* metaObject;
+    QString* name;
+    QRegExp* regExp;
+    // the objects whose children are being walked, with the index of the next child
+    QList<QPair<QPointer<QObject>, int> >* stack;
+};
+
+static void FindChildrenIterator_dealloc(PyObject* self)
+{
+    FindChildrenIterator* it = reinterpret_cast<FindChildrenIterator*>(self);
+    Py_XDECREF(it->pyParent);
+    Py_XDECREF(reinterpret_cast<PyObject*>(it->desiredType));
+    delete it->name;
+    delete it->regExp;
+    delete it->stack;
+    PyObject_Del(self);
+}
+
+static PyObject* FindChildrenIterator_next(PyObject* self)
+{
+    FindChildrenIterator* it = reinterpret_cast<FindChildrenIterator*>(self);
+    while (!it->stack->isEmpty()) {
+        QPair<QPointer<QObject>, int>& top = it->stack->last();
+        // children deleted meanwhile take their descendants with them
+        if (top.first.isNull() || top.second >= top.first->children().size()) {
+            it->stack->removeLast();
+            continue;
+        }
+
+        const QObject* child = top.first->children().at(top.second++);
+        it->stack->append(qMakePair(QPointer<QObject>(const_cast<QObject*>(child)), 0));
+
+        bool nameMatches = it->regExp ? _findChildrenComparator(child, *it->regExp) : _findChildrenComparator(child, *it->name);
+        if (!nameMatches || !_findChildInherits(child, it->metaObject))
+            continue;
+
+        PyObject* pyChild = %CONVERTTOPYTHON[QObject*](child);
+        if (PyType_IsSubtype(pyChild->ob_type, it->desiredType)) {
+            Shiboken::Object::setParent(it->pyParent, pyChild);
+            return pyChild;
+        }
+        Py_DECREF(pyChild);
+    }
+    return 0;
+}
+
+static PyTypeObject FindChildrenIteratorType = {
+    PyVarObject_HEAD_INIT(0, 0)
+    "PySide2.QtCore.FindChildrenIterator", /*tp_name*/
+    sizeof(FindChildrenIterator), /*tp_basicsize*/
+    0,                         /*tp_itemsize*/
+    FindChildrenIterator_dealloc, /*tp_dealloc*/
+    0,                         /*tp_print*/
+    0,                         /*tp_getattr*/
+    0,                         /*tp_setattr*/
+    0,                         /*tp_compare*/
+    0,                         /*tp_repr*/
+    0,                         /*tp_as_number*/
+    0,                         /*tp_as_sequence*/
+    0,                         /*tp_as_mapping*/
+    0,                         /*tp_hash */
+    0,                         /*tp_call*/
+    0,                         /*tp_str*/
+    0,                         /*tp_getattro*/
+    0,                         /*tp_setattro*/
+    0,                         /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT,        /*tp_flags*/
+    0,                         /*tp_doc */
+    0,                         /*tp_traverse */
+    0,                         /*tp_clear */
+    0,                         /*tp_richcompare */
+    0,                         /*tp_weaklistoffset */
+    PyObject_SelfIter,         /*tp_iter */
+    FindChildrenIterator_next, /*tp_iternext */
+    0,                         /*tp_methods */
+    0,                         /*tp_members */
+    0,                         /*tp_getset */
+    0,                         /*tp_base */
+    0,                         /*tp_dict */
+    0,                         /*tp_descr_get */
+    0,                         /*tp_descr_set */
+    0,                         /*tp_dictoffset */
+    0,                         /*tp_init */
+    0,                         /*tp_alloc */
+    0,                         /*tp_new */
+    0,                         /*tp_free */
+    0,                         /*tp_is_gc */
+    0,                         /*tp_bases */
+    0,                         /*tp_mro */
+    0,                         /*tp_cache */
+    0,                         /*tp_subclasses */
+    0,                         /*tp_weaklist */
+    0,                         /*tp_del */
+};
+
+} // extern "C"
+
+static PyObject* _findChildrenIterator(QObject* parent, PyObject* pyParent, PyTypeObject* desiredType,
+                                       const QString* name, const QRegExp* regExp)
+{
+    if (PyType_Ready(&FindChildrenIteratorType) < 0)
+        return 0;
+
+    FindChildrenIterator* it = PyObject_New(FindChildrenIterator, &FindChildrenIteratorType);
+    if (!it)
+        return 0;
+    Py_INCREF(pyParent);
+    it->pyParent = pyParent;
+    Py_INCREF(reinterpret_cast<PyObject*>(desiredType));
+    it->desiredType = desiredType;
+    it->metaObject = _findChildMetaObject(desiredType);
+    it->name = name ? new QString(*name) : 0;
+    it->regExp = regExp ? new QRegExp(*regExp) : 0;
+    it->stack = new QList<QPair<QPointer<QObject>, int> >;
+    it->stack->append(qMakePair(QPointer<QObject>(parent), 0));
+    return reinterpret_cast<PyObject*>(it);
+}
@@ -5,23 +5,26 @@
  */
 
 #include <shiboken.h>
+#include <pyside.h>
 #include <QUiLoader>
+#include <QBuffer>
+#include <QCache>
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QWidget>
 
-static void createChildrenNameAttributes(PyObject* root, QObject* object)
+// Makes the named children of the loaded widget attributes of its wrapper, each one is
+// only wrapped when it is first accessed. A name used twice refers to the first child
+// found walking the tree depth first. Until then the name is not in the __dict__ of the
+// wrapper, so dir() doesn't list it.
+static void createChildrenNameAttributes(QObject* root, QObject* object)
 {
     foreach (QObject* child, object->children()) {
         const QByteArray name = child->objectName().toLocal8Bit();
 
-        if (!name.isEmpty() && !name.startsWith("_") && !name.startsWith("qt_")) {
-            bool hasAttr = PyObject_HasAttrString(root, name.constData());
-            if (!hasAttr) {
-                Shiboken::AutoDecRef pyChild(%CONVERTTOPYTHON[QObject*](child));
-                PyObject_SetAttrString(root, name.constData(), pyChild);
-            }
-            createChildrenNameAttributes(root, child);
-        }
+        if (!name.isEmpty() && !name.startsWith("_") && !name.startsWith("qt_"))
+            PySide::addLazyAttribute(root, name, child);
         createChildrenNameAttributes(root, child);
     }
 }
@@ -32,7 +35,7 @@ static PyObject* QUiLoadedLoadUiFromDevice(QUiLoader* self, QIODevice* dev, QWid
 
     if (wdg) {
         PyObject* pyWdg = %CONVERTTOPYTHON[QWidget*](wdg);
-        createChildrenNameAttributes(pyWdg, wdg);
+        createChildrenNameAttributes(wdg, wdg);
         if (parent) {
             Shiboken::AutoDecRef pyParent(%CONVERTTOPYTHON[QWidget*](parent));
             Shiboken::Object::setParent(pyParent, pyWdg);
@@ -45,8 +48,48 @@ static PyObject* QUiLoadedLoadUiFromDevice(QUiLoader* self, QIODevice* dev, QWid
     return 0;
 }
 
+// The contents of the .ui files loaded by name, so forms created many times are read once.
+// An entry is used while the size and modification time of its file don't change, and the
+// least recently loaded files are dropped once the contents take more than a few megabytes.
+struct UiFileCacheEntry
+{
+    qint64 size;
+    QDateTime lastModified;
+    QByteArray contents;
+};
+
+static QCache<QString, UiFileCacheEntry>& uiFileCache()
+{
+    static QCache<QString, UiFileCacheEntry> cache(4 * 1024 * 1024);
+    return cache;
+}
+
 static PyObject* QUiLoaderLoadUiFromFileName(QUiLoader* self, const QString& uiFile, QWidget* parent)
 {
-    QFile fd(uiFile);
-    return QUiLoadedLoadUiFromDevice(self, &fd, parent);
+    QFileInfo info(uiFile);
+    QString path = info.absoluteFilePath();
+    QCache<QString, UiFileCacheEntry>& cache = uiFileCache();
+
+    QByteArray contents;
+    UiFileCacheEntry* entry = cache.object(path);
+    if (entry && entry->size == info.size() && entry->lastModified == info.lastModified()) {
+        contents = entry->contents;
+    } else {
+        QFile fd(path);
+        if (!fd.open(QIODevice::ReadOnly)) {
+            cache.remove(path);
+            return QUiLoadedLoadUiFromDevice(self, &fd, parent);
+        }
+        contents = fd.readAll();
+        entry = new UiFileCacheEntry;
+        entry->size = info.size();
+        entry->lastModified = info.lastModified();
+        entry->contents = contents;
+        // replaces the outdated entry, files larger than the whole cache aren't kept
+        cache.insert(path, entry, contents.size());
+    }
+
+    QBuffer buffer;
+    buffer.setData(contents);
+    return QUiLoadedLoadUiFromDevice(self, &buffer, parent);
 }
@@ -16,11 +16,47 @@ struct DestroyListenerPrivate
     static bool m_destroyed;
 };
 
+// Set by DestroyListener::destroy(), the hooks left on living objects do nothing afterwards
+static bool listenerDestroyed = false;
+
+// Destroys the wrapper of the object it belongs to. Being deleted with the object, it
+// replaces a destroyed() connection per object without any connect or disconnect.
+// Unlike destroyed(), user data is deleted at the end of ~QObject: the object is already
+// dead and its children, deleted before it, have their wrappers destroyed first. Only
+// the address of the object is used, to find its wrapper.
+class DestroyHook : public QObjectUserData
+{
+public:
+    explicit DestroyHook(QObject* object) : m_object(object) {}
+
+    ~DestroyHook()
+    {
+        if (listenerDestroyed || Py_IsInitialized() == 0)
+            return;
+
+        Shiboken::GilState gil;
+        SbkObject* wrapper = Shiboken::BindingManager::instance().retrieveWrapper(m_object);
+        if (wrapper) //make sure the object exists before destroy
+            Shiboken::Object::destroy(wrapper, m_object);
+    }
+
+private:
+    QObject* m_object;
+};
+
+static uint destroyHookId()
+{
+    static uint id = QObject::registerUserData();
+    return id;
+}
+
 
 DestroyListener* DestroyListener::instance()
 {
-    if (!m_instance)
+    if (!m_instance) {
         m_instance = new DestroyListener(0);
+        listenerDestroyed = false;
+    }
     return m_instance;
 }
 
@@ -31,6 +67,7 @@ void DestroyListener::destroy()
         delete m_instance;
         m_instance = 0;
     }
+    listenerDestroyed = true;
 }
 
 void DestroyListener::listen(QObject *obj)
@@ -41,8 +78,8 @@ void DestroyListener::listen(QObject *obj)
 
     if (Py_IsInitialized() == 0)
         onObjectDestroyed(obj);
-    else
-        QObject::connect(obj, SIGNAL(destroyed(QObject*)), this, SLOT(onObjectDestroyed(QObject*)), Qt::DirectConnection);
+    else if (!obj->userData(destroyHookId()))
+        obj->setUserData(destroyHookId(), new DestroyHook(obj));
 }
 
 void DestroyListener::onObjectDestroyed(QObject* obj)
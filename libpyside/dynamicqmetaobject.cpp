@@ -27,12 +27,17 @@
 #include "pysideproperty.h"
 #include "pysideproperty_p.h"
 #include "pysideslot_p.h"
+#include "invocationplan_p.h"
+#include "metamethodindex_p.h"
+#include "metaobjectcache_p.h"
 
 #include <QByteArray>
 #include <QString>
 #include <QStringList>
 #include <QList>
 #include <QLinkedList>
+#include <QHash>
+#include <QVector>
 #include <QObject>
 #include <cstring>
 #include <QDebug>
@@ -86,6 +91,44 @@ enum MetaDataFlags {
    TypeNameIndexMask = 0x7FFFFFFF
 };
 
+// The strings of a metaobject. Each distinct string is stored once, in the order of
+// registration, and its characters are appended to an arena laid out like the character
+// part of the string data, so the blob size is known at any time and it is copied in one go.
+class MetaStringPool
+{
+public:
+    int registerString(const QByteArray& s)
+    {
+        QHash<QByteArray, int>::const_iterator it = m_indexes.constFind(s);
+        if (it != m_indexes.constEnd())
+            return it.value();
+
+        int index = m_offsets.size();
+        m_indexes.insert(s, index);
+        m_offsets.append(m_chars.size());
+        m_chars.append(s);
+        m_chars.append(char(0));
+        return index;
+    }
+
+    int count() const { return m_offsets.size(); }
+
+    // offset and size of the string \p index inside the arena
+    int offset(int index) const { return m_offsets[index]; }
+    int size(int index) const
+    {
+        int end = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_chars.size();
+        return end - m_offsets[index] - 1;
+    }
+    const char* chars() const { return m_chars.constData(); }
+    int charsSize() const { return m_chars.size(); }
+
+private:
+    QHash<QByteArray, int> m_indexes;
+    QVector<int> m_offsets;
+    QByteArray m_chars;
+};
+
 class DynamicQMetaObject::DynamicQMetaObjectPrivate
 {
 public:
@@ -101,14 +144,41 @@ public:
     int m_emptyMethod;
     int m_nullIndex;
 
+    // Room is left after the method list, the string headers and the data, so slots added to
+    // an up to date metaobject are appended in place instead of rebuilding everything
+    MetaStringPool m_strings;
+    int m_dataCapacity;
+    int m_methodCapacity;
+    int m_stringCapacity;
+    int m_builtMethods;  // entries of m_methods written to the meta data
+    bool m_layoutChanged; // set by any change other than appending slots
+
+    // Metaobjects of instances which registered methods of their own, see derive(). The class
+    // metaobject indexes them by the methods they add, each one keeps its key, the count of
+    // instances using it and the class metaobject, reset when the class goes away first
+    QHash<QByteArray, DynamicQMetaObject*> m_derived;
+    bool m_isDerived;
+    QByteArray m_derivedKey;
+    int m_instances;
+    DynamicQMetaObject* m_owner;
+
+    QByteArray m_qualName; // of the Python class, its meta data can be cached on disk
+
     DynamicQMetaObjectPrivate()
         : m_updated(false), m_methodOffset(0), m_propertyOffset(0),
-          m_dataSize(0), m_emptyMethod(-1), m_nullIndex(0) {}
+          m_dataSize(0), m_emptyMethod(-1), m_nullIndex(0),
+          m_dataCapacity(0), m_methodCapacity(0), m_stringCapacity(0),
+          m_builtMethods(0), m_layoutChanged(true),
+          m_isDerived(false), m_instances(0), m_owner(0) {}
 
-    int createMetaData(QMetaObject* metaObj, QLinkedList<QByteArray> &strings);
+    int createMetaData(QMetaObject* metaObj, MetaStringPool& strings);
     void updateMetaObject(QMetaObject* metaObj);
-    void writeMethodsData(const QList<MethodData>& methods, unsigned int** data, QLinkedList<QByteArray>& strings, int* prtIndex, int nullIndex, int flags);
-    void writeStringData(char *,  QLinkedList<QByteArray> &strings);
+    bool appendSlots(QMetaObject* metaObj);
+    void writeMethodsData(const QList<MethodData>& methods, unsigned int** data, MetaStringPool& strings, int* prtIndex, int nullIndex, int flags);
+    int writeParametersData(const MethodData& method, uint* data, int index);
+    void writeStringData(QMetaObject* metaObj, int firstString);
+    QByteArray cacheContents() const;
+    bool loadCachedMetaData(QMetaObject* metaObj, const QByteArray& cacheKey);
 };
 
 bool sortMethodSignalSlot(const MethodData &m1, const MethodData &m2)
@@ -118,37 +188,9 @@ bool sortMethodSignalSlot(const MethodData &m1, const MethodData &m2)
    return false;
 }
 
-static int registerString(const QByteArray& s, QLinkedList<QByteArray>& strings)
-{
-    int idx = 0;
-    QLinkedList<QByteArray>::const_iterator it = strings.begin();
-    QLinkedList<QByteArray>::const_iterator itEnd = strings.end();
-    while (it != itEnd) {
-        if (strcmp(*it, s) == 0)
-            return idx;
-        ++idx;
-        ++it;
-    }
-    strings.append(s);
-    return idx;
-}
-
-static int blobSize(QLinkedList<QByteArray> &strings)
+static int registerString(const QByteArray& s, MetaStringPool& strings)
 {
-   int size = strings.size() * sizeof(QByteArrayData);
-
-   QByteArray str;
-   QByteArray debug_str;
-   foreach(QByteArray field, strings) {
-      str.append(field);
-      str.append(char(0));
-
-      debug_str.append(field);
-      debug_str.append('|');
-   }
-   //qDebug()<<debug_str;
-   size += str.size();
-   return size;
+    return strings.registerString(s);
 }
 
 static int aggregateParameterCount(const QList<MethodData> &methods)
@@ -159,23 +201,6 @@ static int aggregateParameterCount(const QList<MethodData> &methods)
    return sum;
 }
 
-static void writeString(char *out, int i, const QByteArray &str,
-   const int offsetOfStringdataMember, int &stringdataOffset)
-{
-   int size = str.size();
-   qptrdiff offset = offsetOfStringdataMember + stringdataOffset
-      - i * sizeof(QByteArrayData);
-   const QByteArrayData data =
-      Q_STATIC_BYTE_ARRAY_DATA_HEADER_INITIALIZER_WITH_OFFSET(size, offset);
-
-   memcpy(out + i * sizeof(QByteArrayData), &data, sizeof(QByteArrayData));
-
-   memcpy(out + offsetOfStringdataMember + stringdataOffset, str.constData(), size);
-   out[offsetOfStringdataMember + stringdataOffset + size] = '\0';
-
-   stringdataOffset += size + 1;
-}
-
 static int qvariant_nameToType(const char* name)
 {
     if (!name)
@@ -371,6 +396,13 @@ DynamicQMetaObject::DynamicQMetaObject(PyTypeObject* type, const QMetaObject* ba
     d.static_metacall = NULL;
 
     m_d->m_className = QByteArray(type->tp_name).split('.').last();
+    // only classes defined in Python are worth caching, their name lacks the module
+    if (type->tp_flags & Py_TPFLAGS_HEAPTYPE) {
+        PyObject* module = PyDict_GetItemString(type->tp_dict, "__module__");
+        if (module && Shiboken::String::check(module))
+            m_d->m_qualName = QByteArray(Shiboken::String::toCString(module)) + '.';
+        m_d->m_qualName += type->tp_name;
+    }
     m_d->m_methodOffset = base->methodCount() - 1;
     m_d->m_propertyOffset = base->propertyCount() - 1;
     parsePythonType(type);
@@ -393,6 +425,16 @@ DynamicQMetaObject::DynamicQMetaObject(const char* className, const QMetaObject*
 
 DynamicQMetaObject::~DynamicQMetaObject()
 {
+    // derived metaobjects belong to the instances using them
+    foreach (DynamicQMetaObject* derived, m_d->m_derived)
+        derived->m_d->m_owner = 0;
+    InvocationPlan::invalidate(this);
+    MetaMethodIndex::invalidate(this);
+    if (!m_d->m_properties.isEmpty() && Py_IsInitialized()) {
+        Shiboken::GilState gil;
+        foreach (const PropertyData& property, m_d->m_properties)
+            Py_XDECREF(property.data());
+    }
     free((char *)(d.stringdata));
     free(const_cast<uint*>(d.data));
     delete m_d;
@@ -417,9 +459,13 @@ int DynamicQMetaObject::addMethod(QMetaMethod::MethodType mtype, const char* sig
     if (index != -1) {
         m_d->m_methods[index] = MethodData(mtype, signature, type);
         index++;
+        m_d->m_layoutChanged = true;
     } else {
         m_d->m_methods << MethodData(mtype, signature, type);
         index = m_d->m_methods.size();
+        // signals go before the slots, only slots keep the indexes of existing methods
+        if (mtype != QMetaMethod::Slot)
+            m_d->m_layoutChanged = true;
     }
 
     m_d->m_updated = false;
@@ -434,6 +480,7 @@ void DynamicQMetaObject::removeMethod(QMetaMethod::MethodType mtype, uint index)
         if ((it->signature() == methodSig) && (it->methodType() == mtype)){
             it->clear();
             m_d->m_updated = false;
+            m_d->m_layoutChanged = true;
             break;
         }
     }
@@ -476,6 +523,9 @@ int DynamicQMetaObject::addProperty(const char* propertyName, PyObject* data)
         }
     }
 
+    // qt_metacall() dispatches through the property, which must outlive its class attribute
+    Py_INCREF(data);
+
     //search for a empty space
     PropertyData blank;
     index = m_d->m_properties.indexOf(blank);
@@ -486,12 +536,14 @@ int DynamicQMetaObject::addProperty(const char* propertyName, PyObject* data)
         index = m_d->m_properties.size();
     }
     m_d->m_updated = false;
+    m_d->m_layoutChanged = true;
     return  m_d->m_propertyOffset + index;
 }
 
 void DynamicQMetaObject::addInfo(const char* key, const char* value)
 {
     m_d->m_info[key] = value;
+    m_d->m_layoutChanged = true;
 }
 
 void DynamicQMetaObject::addInfo(QMap<QByteArray, QByteArray> info)
@@ -502,26 +554,96 @@ void DynamicQMetaObject::addInfo(QMap<QByteArray, QByteArray> info)
         ++i;
     }
     m_d->m_updated = false;
+    m_d->m_layoutChanged = true;
 }
 
 const QMetaObject* DynamicQMetaObject::update() const
 {
     if (!m_d->m_updated) {
-        m_d->updateMetaObject(const_cast<DynamicQMetaObject*>(this));
+        if (!m_d->appendSlots(const_cast<DynamicQMetaObject*>(this)))
+            m_d->updateMetaObject(const_cast<DynamicQMetaObject*>(this));
         m_d->m_updated = true;
     }
     return this;
 }
 
+bool DynamicQMetaObject::isUpdated() const
+{
+    return m_d->m_updated;
+}
+
+PySideProperty* DynamicQMetaObject::propertyObject(int index) const
+{
+    index -= m_d->m_propertyOffset + 1;
+    if (index < 0 || index >= m_d->m_properties.size())
+        return 0;
+    return m_d->m_properties[index].data();
+}
+
+DynamicQMetaObject* DynamicQMetaObject::derive(QMetaMethod::MethodType mtype, const char* signature)
+{
+    DynamicQMetaObject* owner = m_d->m_isDerived ? m_d->m_owner : this;
+    QByteArray key = m_d->m_derivedKey;
+    key += mtype == QMetaMethod::Signal ? '2' : '1';
+    key += QMetaObject::normalizedSignature(signature);
+    key += ';';
+
+    DynamicQMetaObject* derived = owner ? owner->m_d->m_derived.value(key) : 0;
+    if (derived) {
+        derived->m_d->m_instances++;
+    } else if (m_d->m_isDerived && m_d->m_instances == 1) {
+        // nobody else sees this metaobject, so it can grow in place
+        if (owner) {
+            owner->m_d->m_derived.remove(m_d->m_derivedKey);
+            owner->m_d->m_derived.insert(key, this);
+        }
+        m_d->m_derivedKey = key;
+        addMethod(mtype, signature, 0);
+        return this;
+    } else {
+        // every derived metaobject extends the class one directly
+        const QMetaObject* base = m_d->m_isDerived ? d.superdata : update();
+        derived = new DynamicQMetaObject(m_d->m_className.constData(), base);
+        derived->m_d->m_isDerived = true;
+        derived->m_d->m_derivedKey = key;
+        derived->m_d->m_instances = 1;
+        derived->m_d->m_owner = owner;
+        if (m_d->m_isDerived)
+            derived->m_d->m_methods = m_d->m_methods;
+        derived->addMethod(mtype, signature, 0);
+        if (owner)
+            owner->m_d->m_derived.insert(key, derived);
+    }
+
+    if (m_d->m_isDerived)
+        releaseDerived(this);
+    return derived;
+}
+
+void DynamicQMetaObject::releaseDerived(DynamicQMetaObject* metaObject)
+{
+    Q_ASSERT(metaObject->m_d->m_isDerived);
+    if (--metaObject->m_d->m_instances > 0)
+        return;
+
+    DynamicQMetaObject* owner = metaObject->m_d->m_owner;
+    if (owner)
+        owner->m_d->m_derived.remove(metaObject->m_d->m_derivedKey);
+    SbkObject* wrapper = Shiboken::BindingManager::instance().retrieveWrapper(metaObject);
+    if (wrapper)
+        Shiboken::BindingManager::instance().releaseWrapper(wrapper);
+    delete metaObject;
+}
+
 void DynamicQMetaObject::DynamicQMetaObjectPrivate::writeMethodsData(const QList<MethodData>& methods,
                                                                      unsigned int** data,
-                                                                     QLinkedList<QByteArray>& strings,
+                                                                     MetaStringPool& strings,
                                                                      int* prtIndex,
                                                                      int nullIndex,
                                                                      int flags)
 {
     int index = *prtIndex;
-    int paramsIndex = index + methods.count() * 5;
+    int paramsIndex = index + m_methodCapacity * 5;
 
     QList<MethodData>::const_iterator it = methods.begin();
 
@@ -547,7 +669,9 @@ void DynamicQMetaObject::DynamicQMetaObjectPrivate::writeMethodsData(const QList
 
         paramsIndex += 1 + argc * 2;
     }
-    *prtIndex = index;
+    // the room left for appended methods
+    std::memset(*data + index, 0, (m_methodCapacity - methods.count()) * 5 * sizeof(uint));
+    *prtIndex = index + (m_methodCapacity - methods.count()) * 5;
 }
 
 void DynamicQMetaObject::parsePythonType(PyTypeObject* type)
@@ -602,15 +726,13 @@ void DynamicQMetaObject::parsePythonType(PyTypeObject* type)
     // Register properties
     foreach (PropPair propPair, properties)
         addProperty(propPair.first, propPair.second);
-
-    
 }
 
 /*!
   Allocate the meta data table.
   Returns the index in the table corresponding to the header fields count.
 */
-int DynamicQMetaObject::DynamicQMetaObjectPrivate::createMetaData(QMetaObject* metaObj, QLinkedList<QByteArray> &strings)
+int DynamicQMetaObject::DynamicQMetaObjectPrivate::createMetaData(QMetaObject* metaObj, MetaStringPool& strings)
 {
     uint n_methods = m_methods.size();
     uint n_properties = m_properties.size();
@@ -629,15 +751,18 @@ int DynamicQMetaObject::DynamicQMetaObjectPrivate::createMetaData(QMetaObject* m
 
     const int HEADER_LENGHT = sizeof(header)/sizeof(int);
 
+    m_methodCapacity = n_methods + qMax<int>(n_methods / 2, 4);
+
     m_dataSize = HEADER_LENGHT;
     m_dataSize += n_info*2;        //class info: name, value
-    m_dataSize += n_methods*5;     //method: name, argc, parameters, tag, flags
+    m_dataSize += m_methodCapacity*5; //method: name, argc, parameters, tag, flags
     m_dataSize += n_properties*4;  //property: name, type, flags
     m_dataSize += 1;               //eod
     
     m_dataSize += aggregateParameterCount(m_methods); // types and parameter names
 
-    uint* data = reinterpret_cast<uint*>(realloc(const_cast<uint*>(metaObj->d.data), m_dataSize * sizeof(uint)));
+    m_dataCapacity = m_dataSize;
+    uint* data = reinterpret_cast<uint*>(realloc(const_cast<uint*>(metaObj->d.data), m_dataCapacity * sizeof(uint)));
 
     Q_ASSERT(data);
     std::memcpy(data, header, sizeof(header));
@@ -650,29 +775,126 @@ int DynamicQMetaObject::DynamicQMetaObjectPrivate::createMetaData(QMetaObject* m
 // Writes strings to string data struct.
 // The struct consists of an array of QByteArrayData, followed by a char array
 // containing the actual strings. This format must match the one produced by
-// moc (see generator.cpp).
-void DynamicQMetaObject::DynamicQMetaObjectPrivate::writeStringData(char *out,  QLinkedList<QByteArray> &strings)
-{
+// moc (see generator.cpp). Headers are self relative, so the array has room for more
+// strings and only the ones from \p firstString on are written while it doesn't overflow.
+void DynamicQMetaObject::DynamicQMetaObjectPrivate::writeStringData(QMetaObject* metaObj, int firstString)
+{
+   int count = m_strings.count();
+   if (firstString == 0 || count > m_stringCapacity) {
+      m_stringCapacity = count + qMax(count / 2, 8);
+      firstString = 0;
+   }
+
+   int offsetOfStringdataMember = m_stringCapacity * sizeof(QByteArrayData);
+   int size = offsetOfStringdataMember + m_strings.charsSize();
+   char* out = reinterpret_cast<char*>(realloc(const_cast<QByteArrayData*>(metaObj->d.stringdata), size));
    Q_ASSERT(!(reinterpret_cast<quintptr>(out) & (Q_ALIGNOF(QByteArrayData)-1)));
 
-   int offsetOfStringdataMember = strings.size() * sizeof(QByteArrayData);
-   int stringdataOffset = 0;
-   int i = 0;
-   foreach(const QByteArray& str, strings) {
-      writeString(out, i, str, offsetOfStringdataMember, stringdataOffset);
-      i++;
+   // the room left for more strings is stored in the meta object cache too, and must not
+   // carry whatever realloc() left there
+   if (firstString == 0)
+      memset(out + count * sizeof(QByteArrayData), 0, (m_stringCapacity - count) * sizeof(QByteArrayData));
+
+   for (int i = firstString; i < count; ++i) {
+      qptrdiff offset = offsetOfStringdataMember + m_strings.offset(i) - i * sizeof(QByteArrayData);
+      const QByteArrayData data =
+         Q_STATIC_BYTE_ARRAY_DATA_HEADER_INITIALIZER_WITH_OFFSET(m_strings.size(i), offset);
+      memcpy(out + i * sizeof(QByteArrayData), &data, sizeof(QByteArrayData));
+   }
+   if (firstString < count) {
+      int firstChar = m_strings.offset(firstString);
+      memcpy(out + offsetOfStringdataMember + firstChar, m_strings.chars() + firstChar, m_strings.charsSize() - firstChar);
    }
+   metaObj->d.stringdata = reinterpret_cast<const QByteArrayData*>(out);
+}
+
+// Writes the return and parameter types of \p method at \p index, followed by the
+// parameter names, and returns the index after them.
+int DynamicQMetaObject::DynamicQMetaObjectPrivate::writeParametersData(const MethodData& method, uint* data, int index)
+{
+    QList<QByteArray> paramTypeNames = method.parameterTypes();
+    int paramCount = paramTypeNames.size();
+    for (int i = -1; i < paramCount; ++i) {
+        const QByteArray &typeName = (i < 0) ? method.returnType() : paramTypeNames.at(i);
+        int typeInfo;
+        if (QtPrivate::isBuiltinType(typeName))
+            typeInfo = QMetaType::type(typeName);
+        else
+            typeInfo = IsUnresolvedType | registerString(typeName, m_strings);
+        data[index++] = typeInfo;
+    }
+
+    // Parameter names (use a null string)
+    for (int i = 0; i < paramCount; ++i)
+        data[index++] = m_nullIndex;
+    return index;
 }
 
+// Writes the slots added since the last update in the room left for them, existing
+// method indexes don't change so the cached invocation plans stay valid.
+// Returns false if a full update is needed.
+bool DynamicQMetaObject::DynamicQMetaObjectPrivate::appendSlots(QMetaObject* metaObj)
+{
+    int count = m_methods.size();
+    if (m_layoutChanged || count > m_methodCapacity)
+        return false;
+
+    int needed = 0;
+    for (int i = m_builtMethods; i < count; ++i)
+        needed += 1 + m_methods[i].parameterCount() * 2;
+
+    uint* data = const_cast<uint*>(metaObj->d.data);
+    if (m_dataSize + needed > m_dataCapacity) {
+        m_dataCapacity = qMax(m_dataCapacity + m_dataCapacity / 2, m_dataSize + needed);
+        data = reinterpret_cast<uint*>(realloc(data, m_dataCapacity * sizeof(uint)));
+        Q_ASSERT(data);
+        metaObj->d.data = data;
+    }
+
+    int firstString = m_strings.count();
+    int paramsIndex = m_dataSize - 1; // over the end marker
+    for (int i = m_builtMethods; i < count; ++i) {
+        const MethodData& method = m_methods[i];
+        uint* entry = data + data[5] + i * 5;
+        entry[0] = registerString(method.name(), m_strings);
+        entry[1] = method.parameterCount();
+        entry[2] = paramsIndex;
+        entry[3] = m_nullIndex;
+        entry[4] = AccessPublic | MethodSlot;
+        paramsIndex = writeParametersData(method, data, paramsIndex);
+    }
+    data[paramsIndex++] = 0; // the end
+
+    data[4] = count;
+    m_dataSize = paramsIndex;
+    m_builtMethods = count;
+    writeStringData(metaObj, firstString);
+    return true;
+}
 
 void DynamicQMetaObject::DynamicQMetaObjectPrivate::updateMetaObject(QMetaObject* metaObj)
 {
     Q_ASSERT(!m_updated);
+    // method indexes may change, drop the argument converters cached for the old layout
+    InvocationPlan::invalidate(metaObj);
+    MetaMethodIndex::invalidate(metaObj);
     uint *data = const_cast<uint*>(metaObj->d.data);
     int index = 0;
-    QLinkedList<QByteArray> strings;
+    m_strings = MetaStringPool();
+    MetaStringPool& strings = m_strings;
+    m_emptyMethod = -1;
     m_dataSize = 0;
 
+    //signals must be written first, see indexOfMethodRelative in qmetaobject.cpp
+    qStableSort(m_methods.begin(), m_methods.end(), sortMethodSignalSlot);
+
+    QByteArray cacheKey;
+    if (!m_qualName.isEmpty() && MetaObjectCache::isEnabled()) {
+        cacheKey = MetaObjectCache::key(m_qualName, cacheContents());
+        if (loadCachedMetaData(metaObj, cacheKey))
+            return;
+    }
+
     // Recompute the size and reallocate memory
     // index is set after the last header field
     index = createMetaData(metaObj, strings);
@@ -721,46 +943,74 @@ void DynamicQMetaObject::DynamicQMetaObjectPrivate::updateMetaObject(QMetaObject
         }
     }
 
-    //write signals/slots (signals must be written first, see indexOfMethodRelative in qmetaobject.cpp)
-    qStableSort(m_methods.begin(), m_methods.end(), sortMethodSignalSlot);
-
-    if (m_methods.size()) {
-        if (data[5] == 0)
-            data[5] = index;
-
-        writeMethodsData(m_methods, &data, strings, &index, m_nullIndex, AccessPublic);
-    }
+    //write signals/slots
+    // the method list is always placed, it has room for the slots appended later
+    data[5] = index;
+    writeMethodsData(m_methods, &data, strings, &index, m_nullIndex, AccessPublic);
 
     //write signal/slots parameters
-    if (m_methods.size()) {
-       QList<MethodData>::iterator it = m_methods.begin();
-       for (; it != m_methods.end(); ++it) {
-          QList<QByteArray> paramTypeNames = it->parameterTypes();
-          int paramCount = paramTypeNames.size();
-          for (int i = -1; i < paramCount; ++i) {
-             const QByteArray &typeName = (i < 0) ? it->returnType() : paramTypeNames.at(i);
-             int typeInfo;
-             if (QtPrivate::isBuiltinType(typeName))
-                typeInfo = QMetaType::type(typeName);
-             else
-                typeInfo = IsUnresolvedType | registerString(typeName, strings);
-             data[index++] = typeInfo;
-          }
-
-          // Parameter names (use a null string)
-          for (int i = 0; i < paramCount; ++i) {
-             data[index++] = m_nullIndex;
-          }
-       }
-    }
+    QList<MethodData>::const_iterator it = m_methods.constBegin();
+    for (; it != m_methods.constEnd(); ++it)
+        index = writeParametersData(*it, data, index);
 
     data[index++] = 0; // the end
+    Q_ASSERT(index == m_dataSize);
 
     // create the m_metadata string
-    int size = blobSize(strings);
-    char *blob = reinterpret_cast<char *>(realloc((char*)metaObj->d.stringdata, size));
-    writeStringData(blob, strings);
+    writeStringData(metaObj, 0);
 
-    metaObj->d.stringdata = reinterpret_cast<const QByteArrayData *>(blob);
     metaObj->d.data = data;
+    m_builtMethods = m_methods.size();
+    m_layoutChanged = false;
+
+    if (!cacheKey.isEmpty())
+        MetaObjectCache::store(cacheKey, metaObj, m_dataSize, m_stringCapacity * sizeof(QByteArrayData) + m_strings.charsSize());
+}
+
+// Everything the meta data written by updateMetaObject() depends on
+QByteArray DynamicQMetaObject::DynamicQMetaObjectPrivate::cacheContents() const
+{
+    QByteArray contents = m_className;
+    contents += '\n';
+    foreach (const MethodData& method, m_methods) {
+        contents += QByteArray::number(method.methodType());
+        contents += ' ';
+        contents += method.returnType();
+        contents += ' ';
+        contents += method.signature();
+        contents += '\n';
+    }
+    foreach (const PropertyData& property, m_properties) {
+        if (property.isValid()) {
+            contents += property.name();
+            contents += ' ';
+            contents += property.type();
+            contents += ' ';
+            contents += QByteArray::number(property.flags());
+            contents += ' ';
+            contents += QByteArray::number(property.notifyId());
+        }
+        contents += '\n';
+    }
+    QMap<QByteArray, QByteArray>::const_iterator i = m_info.constBegin();
+    for (; i != m_info.constEnd(); ++i) {
+        contents += i.key();
+        contents += '=';
+        contents += i.value();
+        contents += '\n';
+    }
+    return contents;
+}
+
+bool DynamicQMetaObject::DynamicQMetaObjectPrivate::loadCachedMetaData(QMetaObject* metaObj, const QByteArray& cacheKey)
+{
+    int stringDataSize = 0;
+    if (!MetaObjectCache::load(cacheKey, metaObj, &m_dataSize, &stringDataSize))
+        return false;
+
+    // the string pool isn't stored, so the next change rebuilds everything
+    m_dataCapacity = m_dataSize;
+    m_builtMethods = m_methods.size();
+    m_layoutChanged = true;
+    return true;
 }
@@ -28,6 +28,8 @@
 #include <QMetaObject>
 #include <QMetaMethod>
 
+struct PySideProperty;
+
 namespace PySide
 {
 
@@ -53,6 +55,29 @@ public:
 
     const QMetaObject* update() const;
 
+    /**
+     * Return true if update() has nothing to write. Unlike building the meta data, using an
+     * up to date metaobject doesn't need the GIL.
+     **/
+    bool isUpdated() const;
+
+    /**
+     * Return the Python property object of the property \p index, 0 if it isn't declared by this
+     * metaobject. The GIL isn't needed, the metaobject holds a reference to the property so it
+     * outlives the class attribute.
+     **/
+    PySideProperty* propertyObject(int index) const;
+
+    /**
+     * Return the metaobject of an instance whose metaobject is this one after it registers the
+     * extra method \p signature. This is the class metaobject or one returned by derive().
+     * Instances registering the same methods in the same order share one metaobject, changed in
+     * place only while a single instance uses it. The reference the instance held to this
+     * metaobject moves to the returned one, it is given back with releaseDerived().
+     **/
+    DynamicQMetaObject* derive(QMetaMethod::MethodType mtype, const char* signature);
+    static void releaseDerived(DynamicQMetaObject* metaObject);
+
 private:
     class DynamicQMetaObjectPrivate;
     DynamicQMetaObjectPrivate* m_d;
@@ -71,6 +71,7 @@ namespace PySide
         uint flags() const;
         bool isValid() const;
         int notifyId() const;
+        PySideProperty* data() const { return m_data; }
         bool operator==(const PropertyData& other) const;
         bool operator==(const char* name) const;
 
@@ -23,6 +23,7 @@
 #include "globalreceiver.h"
 #include "dynamicqmetaobject_p.h"
 #include "pysideweakref.h"
+#include "invocationplan_p.h"
 
 #include <QMetaMethod>
 #include <QDebug>
@@ -47,6 +48,7 @@ class DynamicSlotData
         void decRef(const QObject* o);
         void clear();
         int hasRefTo(const QObject* o) const;
+        const QLinkedList<const QObject*>& refs() const;
         int refCount() const;
         int id() const;
         PyObject* call(PyObject* args);
@@ -140,6 +142,11 @@ int DynamicSlotData::hasRefTo(const QObject *o) const
     return m_refs.count(o);
 }
 
+const QLinkedList<const QObject*>& DynamicSlotData::refs() const
+{
+    return m_refs;
+}
+
 void DynamicSlotData::clear()
 {
     Shiboken::GilState gil;
@@ -195,6 +202,7 @@ void GlobalReceiver::connectNotify(QObject* source, int slotId)
         if (!data->hasRefTo(source))
             QObject::connect(source, SIGNAL(destroyed(QObject*)), this, "1" RECEIVER_DESTROYED_SLOT_NAME);
         data->addRef(source);
+        m_sourceRefs[source]++;
     }
 }
 
@@ -202,7 +210,10 @@ void GlobalReceiver::disconnectNotify(QObject* source, int slotId)
 {
    if (m_slotReceivers.contains(slotId)) {
         DynamicSlotData *data = m_slotReceivers[slotId];
-        data->decRef(source);
+        if (data->hasRefTo(source)) {
+            data->decRef(source);
+            removeSourceRef(source);
+        }
         if (data->refCount() == 0)
             removeSlot(slotId);
 
@@ -240,22 +251,25 @@ int GlobalReceiver::addSlot(const char* slot, PyObject* callback)
 void GlobalReceiver::removeSlot(int slotId)
 {
     if (m_slotReceivers.contains(slotId)) {
-        delete m_slotReceivers.take(slotId);
+        DynamicSlotData* data = m_slotReceivers.take(slotId);
+        foreach (const QObject* source, data->refs())
+            removeSourceRef(source);
+        delete data;
         m_metaObject.removeSlot(slotId);
         m_shortCircuitSlots.remove(slotId);
     }
 }
 
+void GlobalReceiver::removeSourceRef(const QObject* source)
+{
+    QHash<const QObject*, int>::iterator it = m_sourceRefs.find(source);
+    if (it != m_sourceRefs.end() && --it.value() == 0)
+        m_sourceRefs.erase(it);
+}
+
 bool GlobalReceiver::hasConnectionWith(const QObject *object)
 {
-    QHash<int, DynamicSlotData*>::iterator i = m_slotReceivers.begin();
-    while(i != m_slotReceivers.end()) {
-        if (i.value()->hasRefTo(object)) {
-            return true;
-        }
-        i++;
-    }
-    return false;
+    return m_sourceRefs.contains(object);
 }
 
 int GlobalReceiver::qt_metacall(QMetaObject::Call call, int id, void** args)
@@ -294,14 +308,9 @@ int GlobalReceiver::qt_metacall(QMetaObject::Call call, int id, void** args)
     if (m_shortCircuitSlots.contains(id)) {
         retval = data->call(reinterpret_cast<PyObject*>(args[1]));
     } else {
-        QList<QByteArray> paramTypes = slot.parameterTypes();
-        Shiboken::AutoDecRef preparedArgs(PyTuple_New(paramTypes.count()));
-        for (int i = 0, max = paramTypes.count(); i < max; ++i) {
-            const QByteArray& paramType = paramTypes[i];
-            Shiboken::Conversions::SpecificConverter converter(paramType.constData());
-            PyTuple_SET_ITEM(preparedArgs.object(), i, converter.toPython(args[i+1]));
-        }
-        retval = data->call(preparedArgs);
+        Shiboken::AutoDecRef preparedArgs(EmissionScope::arguments(InvocationPlan::get(slot).data(), args));
+        if (!preparedArgs.isNull())
+            retval = data->call(preparedArgs);
     }
 
     if (!retval)
@@ -52,9 +52,12 @@ protected:
   using QObject::disconnectNotify;
 
 private:
+    void removeSourceRef(const QObject* source);
+
     DynamicQMetaObject m_metaObject;
     QSet<int> m_shortCircuitSlots;
     QHash<int, DynamicSlotData* > m_slotReceivers;
+    QHash<const QObject*, int> m_sourceRefs; // connections made by each source
 };
 
 }
@@ -23,6 +23,7 @@
 #include "globalreceiverv2.h"
 #include "dynamicqmetaobject_p.h"
 #include "pysideweakref.h"
+#include "invocationplan_p.h"
 
 #include <QMetaMethod>
 #include <QDebug>
@@ -30,11 +31,19 @@
 #include <QLinkedList>
 #include <autodecref.h>
 #include <gilstate.h>
+#include <cstring>
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QScopedPointer>
+#include <QThread>
+#include <QTimerEvent>
+#include <QVarLengthArray>
 
 #include "typeresolver.h"
 #include "signalmanager.h"
 
 #define RECEIVER_DESTROYED_SLOT_NAME "__receiverDestroyed__(QObject*)"
+#define RECEIVER_SLOT_NAME "__callback__"
 
 namespace
 {
@@ -50,14 +59,12 @@ class DynamicSlotDataV2
         DynamicSlotDataV2(PyObject* callback, GlobalReceiverV2* parent);
         ~DynamicSlotDataV2();
 
-        int addSlot(const char* signature);
-        int id(const char* signature) const;
         PyObject* callback();
-        QByteArray hash() const;
+        GlobalReceiverKey key() const;
         void notify();
 
         static void onCallbackDestroyed(void* data);
-        static QByteArray hash(PyObject *callback);
+        static GlobalReceiverKey key(PyObject *callback);
 
 
     private:
@@ -66,9 +73,8 @@ class DynamicSlotDataV2
         PyObject* m_pythonSelf;
         PyObject* m_pyClass;
         PyObject* m_weakRef;
-        QMap<QByteArray, int> m_signatures;
         GlobalReceiverV2* m_parent;
-        QByteArray m_hash;
+        GlobalReceiverKey m_key;
 };
 
 }
@@ -92,31 +98,28 @@ DynamicSlotDataV2::DynamicSlotDataV2(PyObject* callback, GlobalReceiverV2* paren
 
         //monitor class from method lifetime
         m_weakRef = WeakRef::create(m_pythonSelf, DynamicSlotDataV2::onCallbackDestroyed, this);
-
-        m_hash = QByteArray::number((qlonglong)PyObject_Hash(m_callback))
-                 + QByteArray::number((qlonglong)PyObject_Hash(m_pythonSelf));
-
     } else {
         m_callback = callback;
         Py_INCREF(m_callback);
-
-        m_hash = QByteArray::number((qlonglong)PyObject_Hash(m_callback));
     }
+    m_key = key(callback);
 }
 
-QByteArray DynamicSlotDataV2::hash() const
+GlobalReceiverKey DynamicSlotDataV2::key() const
 {
-    return m_hash;
+    return m_key;
 }
 
-QByteArray DynamicSlotDataV2::hash(PyObject* callback)
+GlobalReceiverKey DynamicSlotDataV2::key(PyObject* callback)
 {
-    Shiboken::GilState gil;
     if (PyMethod_Check(callback))
-        return  QByteArray::number((qlonglong)PyObject_Hash(PyMethod_GET_FUNCTION(callback)))
-              + QByteArray::number((qlonglong)PyObject_Hash(PyMethod_GET_SELF(callback)));
-    else
-        return QByteArray::number((qlonglong)PyObject_Hash(callback));
+        return GlobalReceiverKey(PyMethod_GET_FUNCTION(callback), PyMethod_GET_SELF(callback));
+
+    // Builtin methods are new objects on each attribute access, use what they are bound to
+    if (PyCFunction_Check(callback) && PyCFunction_GET_SELF(callback))
+        return GlobalReceiverKey(reinterpret_cast<PyCFunctionObject*>(callback)->m_ml, PyCFunction_GET_SELF(callback));
+
+    return GlobalReceiverKey(callback, 0);
 }
 
 PyObject* DynamicSlotDataV2::callback()
@@ -136,23 +139,6 @@ PyObject* DynamicSlotDataV2::callback()
     return callback;
 }
 
-int DynamicSlotDataV2::id(const char* signature) const
-{
-    if (m_signatures.contains(signature))
-        return m_signatures[signature];
-    return -1;
-}
-
-int DynamicSlotDataV2::addSlot(const char* signature)
-{
-    int index = id(signature);
-    if (index == -1) {
-        DynamicQMetaObject *dmo = const_cast<DynamicQMetaObject*>(reinterpret_cast<const DynamicQMetaObject*>(m_parent->metaObject()));
-        index = m_signatures[signature] = dmo->addSlot(signature);
-    }
-    return index;
-}
-
 void DynamicSlotDataV2::onCallbackDestroyed(void *data)
 {
     DynamicSlotDataV2* self = reinterpret_cast<DynamicSlotDataV2*>(data);
@@ -173,115 +159,195 @@ DynamicSlotDataV2::~DynamicSlotDataV2()
        Py_DECREF(m_callback);
 }
 
-GlobalReceiverV2::GlobalReceiverV2(PyObject *callback, SharedMap map)
-    : QObject(0), m_metaObject(GLOBAL_RECEIVER_CLASS_NAME, &QObject::staticMetaObject), m_sharedMap(map)
+// The slot table shared by all receivers, the callback is known by the receiver itself, so
+// slots only need to differ by their arguments and the table grows with the number of
+// distinct signatures instead of the number of connected callables.
+struct SlotTable
 {
-    m_data = new DynamicSlotDataV2(callback, this);
-    m_metaObject.addSlot(RECEIVER_DESTROYED_SLOT_NAME);
-    m_metaObject.update();
-    m_refs.append(NULL);
+    SlotTable() : metaObject(GLOBAL_RECEIVER_CLASS_NAME, &QObject::staticMetaObject)
+    {
+        metaObject.addSlot(RECEIVER_DESTROYED_SLOT_NAME);
+        DESTROY_SLOT_ID = metaObject.update()->indexOfSlot(RECEIVER_DESTROYED_SLOT_NAME);
+        DESTROY_SIGNAL_ID = QObject::staticMetaObject.indexOfSignal("destroyed(QObject*)");
+    }
 
+    DynamicQMetaObject metaObject;
+    QHash<QByteArray, int> indexes;
+};
 
-    if (DESTROY_SIGNAL_ID == 0)
-        DESTROY_SIGNAL_ID = QObject::staticMetaObject.indexOfSignal("destroyed(QObject*)");
+static SlotTable& slotTable()
+{
+    static SlotTable table;
+    return table;
+}
 
-    if (DESTROY_SLOT_ID == 0)
-        DESTROY_SLOT_ID = m_metaObject.indexOfSlot(RECEIVER_DESTROYED_SLOT_NAME);
+// Number of receivers linked to each QObject, kept up to date as links come and go
+// so counting the receivers of an object being destroyed doesn't visit all of them.
+// Receivers are also deleted with the GIL released, so the index has its own lock.
+struct LinkIndex
+{
+    QMutex mutex;
+    QHash<const QObject*, int> counts;
+};
+Q_GLOBAL_STATIC(LinkIndex, linkIndex)
 
+static void addLink(const QObject* link)
+{
+    LinkIndex* index = linkIndex();
+    if (!index)
+        return;
+    QMutexLocker locker(&index->mutex);
+    index->counts[link]++;
+}
 
+static void removeLink(const QObject* link)
+{
+    LinkIndex* index = linkIndex();
+    if (!index)
+        return;
+    QMutexLocker locker(&index->mutex);
+    QHash<const QObject*, int>::iterator it = index->counts.find(link);
+    if (it != index->counts.end() && --it.value() == 0)
+        index->counts.erase(it);
+}
+
+GlobalReceiverV2::GlobalReceiverV2(PyObject *callback, SharedMap map)
+    : QObject(0), m_ref(1), m_lastLink(0), m_sharedMap(map)
+{
+    m_data = new DynamicSlotDataV2(callback, this);
+    m_refs.insert(0, 1);
+    slotTable(); // resolves the ids of the destroyed() signal and slot
 }
 
 GlobalReceiverV2::~GlobalReceiverV2()
 {
+    QHash<const QObject*, int>::const_iterator it = m_refs.constBegin();
+    for (; it != m_refs.constEnd(); ++it) {
+        if (it.key())
+            removeLink(it.key());
+    }
     m_refs.clear();
     //Remove itself from map
-    m_sharedMap->remove(m_data->hash());
+    m_sharedMap->remove(m_data->key());
     delete m_data;
 }
 
+// Index of the slot with the arguments of \p signature on the shared slot table
+static int slotTableIndex(const char* signature)
+{
+    // drop the encoded callback name, the slot index is shared with other receivers
+    const char* arguments = std::strchr(signature, '(');
+    QByteArray slot(RECEIVER_SLOT_NAME);
+    if (arguments)
+        slot += arguments;
+    SlotTable& table = slotTable();
+    int& index = table.indexes[slot];
+    if (!index)
+        index = table.metaObject.addSlot(slot);
+    return index;
+}
+
 int GlobalReceiverV2::addSlot(const char* signature)
 {
-    return m_data->addSlot(signature);
+    return slotTableIndex(signature);
 }
 
 void GlobalReceiverV2::incRef(const QObject* link)
 {
-    if (link) {
-        if (!m_refs.contains(link)) {
-            bool connected;
-            Py_BEGIN_ALLOW_THREADS
-            connected = QMetaObject::connect(link, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
-            Py_END_ALLOW_THREADS
-            if (connected)
-                m_refs.append(link);
-            else
-                Q_ASSERT(false);
-        } else {
-            m_refs.append(link);
+    if (link && !m_refs.contains(link)) {
+        bool connected;
+        Py_BEGIN_ALLOW_THREADS
+        connected = QMetaObject::connect(link, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
+        Py_END_ALLOW_THREADS
+        if (!connected) {
+            Q_ASSERT(false);
+            return;
         }
-    } else {
-        m_refs.append(NULL);
+        addLink(link);
     }
+    m_refs[link]++;
+    m_ref++;
+    if (link)
+        m_lastLink = link;
 }
 
 void GlobalReceiverV2::decRef(const QObject* link)
 {
-    if (m_refs.size() <= 0)
+    if (m_ref <= 0)
         return;
 
-
-    m_refs.removeOne(link);
-    if (link) {
-        if (!m_refs.contains(link)) {
-            bool result;
-            Py_BEGIN_ALLOW_THREADS
-            result = QMetaObject::disconnect(link, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
-            Py_END_ALLOW_THREADS
-            Q_ASSERT(result);
-            if (!result)
-                return;
+    QHash<const QObject*, int>::iterator it = m_refs.find(link);
+    if (it != m_refs.end()) {
+        m_ref--;
+        if (--it.value() == 0) {
+            m_refs.erase(it);
+            if (link) {
+                removeLink(link);
+                if (link == m_lastLink)
+                    m_lastLink = 0;
+                bool result;
+                Py_BEGIN_ALLOW_THREADS
+                result = QMetaObject::disconnect(link, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
+                Py_END_ALLOW_THREADS
+                Q_ASSERT(result);
+                if (!result)
+                    return;
+            }
         }
+    } else if (link) {
+        return;
     }
 
-    if (m_refs.size() == 0)
+    if (m_ref == 0)
         Py_BEGIN_ALLOW_THREADS
         delete this;
         Py_END_ALLOW_THREADS
 
 }
 
+int GlobalReceiverV2::linkedReceivers(const QObject* link)
+{
+    LinkIndex* index = linkIndex();
+    if (!index)
+        return 0;
+    QMutexLocker locker(&index->mutex);
+    return index->counts.value(link);
+}
+
 int GlobalReceiverV2::refCount(const QObject* link) const
 {
     if (link)
-        return m_refs.count(link);
+        return m_refs.value(link);
 
-    return m_refs.size();
+    return m_ref;
 }
 
 void GlobalReceiverV2::notify()
 {
-    QSet<const QObject*> objs = QSet<const QObject*>::fromList(m_refs);
+    // The destroyed() connection of the object linked last must come after the connection
+    // just made, otherwise a slot connected to destroyed() would never be called.
+    const QObject* link = m_lastLink;
+    if (!link)
+        return;
     Py_BEGIN_ALLOW_THREADS
-    foreach(const QObject* o, objs) {
-        QMetaObject::disconnect(o, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
-        QMetaObject::connect(o, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
-    }
+    QMetaObject::disconnect(link, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
+    QMetaObject::connect(link, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
     Py_END_ALLOW_THREADS
 }
 
-QByteArray GlobalReceiverV2::hash() const
+GlobalReceiverKey GlobalReceiverV2::key() const
 {
-    return m_data->hash();
+    return m_data->key();
 }
 
-QByteArray GlobalReceiverV2::hash(PyObject* callback)
+GlobalReceiverKey GlobalReceiverV2::key(PyObject* callback)
 {
-    return DynamicSlotDataV2::hash(callback);
+    return DynamicSlotDataV2::key(callback);
 }
 
 const QMetaObject* GlobalReceiverV2::metaObject() const
 {
-    return m_metaObject.update();
+    return slotTable().metaObject.update();
 }
 
 int GlobalReceiverV2::qt_metacall(QMetaObject::Call call, int id, void** args)
@@ -294,17 +360,234 @@ int GlobalReceiverV2::qt_metacall(QMetaObject::Call call, int id, void** args)
     Q_ASSERT(slot.methodType() == QMetaMethod::Slot);
 
     if (id == DESTROY_SLOT_ID) {
-        if (m_refs.size() == 0)
+        if (m_ref == 0)
             return -1;
         QObject *obj = *(QObject**)args[1];
         incRef(); //keep the object live (safe ref)
-        m_refs.removeAll(obj); // remove all refs to this object
+        if (m_refs.contains(obj)) {
+            m_ref -= m_refs.take(obj); // remove all refs to this object
+            removeLink(obj);
+        }
+        if (obj == m_lastLink)
+            m_lastLink = 0;
         decRef(); //remove the safe ref
     } else {
-        bool isShortCuit = (strstr(slot.methodSignature(), "(") == 0);
+        bool isShortCuit = InvocationPlan::get(slot)->isShortCircuit();
         Shiboken::AutoDecRef callback(m_data->callback());
         SignalManager::callPythonMetaMethod(slot, args, callback, isShortCuit);
     }
 
     return -1;
 }
+
+typedef QPair<const QObject*, int> CoalescedKey;
+typedef QMultiHash<CoalescedKey, CoalescedReceiver*> CoalescedMap;
+
+// The coalesced receivers of each signal, only touched with the GIL held
+static CoalescedMap& coalescedReceivers()
+{
+    static CoalescedMap receivers;
+    return receivers;
+}
+
+static QEvent::Type deliverEventType()
+{
+    static int type = QEvent::registerEventType();
+    return static_cast<QEvent::Type>(type);
+}
+
+CoalescedReceiver::CoalescedReceiver(QObject* source, int signalIndex, GlobalReceiverV2* receiver, int slotIndex, int interval)
+    : QObject(0), m_source(source), m_signalIndex(signalIndex), m_receiver(receiver), m_slotIndex(slotIndex),
+      m_interval(interval), m_holdsPythonObjects(false), m_pending(false)
+{
+    slotTable(); // resolves the ids of the destroyed() signal and slot
+}
+
+CoalescedReceiver::~CoalescedReceiver()
+{
+    Shiboken::GilState gil;
+    if (m_source)
+        coalescedReceivers().remove(CoalescedKey(m_source, m_signalIndex), this);
+    clearValues(m_values);
+    // the reference taken by SignalManager::globalReceiver() for this connection
+    if (m_source && m_receiver)
+        static_cast<GlobalReceiverV2*>(m_receiver.data())->decRef(m_source);
+}
+
+CoalescedReceiver* CoalescedReceiver::find(const QObject* source, int signalIndex, PyObject* callback)
+{
+    GlobalReceiverKey key = GlobalReceiverV2::key(callback);
+    CoalescedMap::const_iterator it = coalescedReceivers().constFind(CoalescedKey(source, signalIndex));
+    for (; it != coalescedReceivers().constEnd() && it.key() == CoalescedKey(source, signalIndex); ++it) {
+        GlobalReceiverV2* receiver = it.value()->receiver();
+        if (receiver && receiver->key() == key)
+            return it.value();
+    }
+    return 0;
+}
+
+bool CoalescedReceiver::connect()
+{
+    QMetaMethod signal = m_source->metaObject()->method(m_signalIndex);
+    const int pythonType = qMetaTypeId<PyObjectWrapper>();
+    foreach (const QByteArray& typeName, signal.parameterTypes()) {
+        int type = QMetaType::type(typeName.constData());
+        if (!type) {
+            PyErr_Format(PyExc_TypeError, "Arguments of coalesced connections need to be registered on meta type: %s",
+                         typeName.constData());
+            return false;
+        }
+        bool objectPointer = QMetaType::typeFlags(type) & QMetaType::PointerToQObject;
+        if (!objectPointer && typeName.endsWith('*')) {
+            PyErr_Format(PyExc_TypeError, "Coalesced connections can't keep pointer arguments until they are delivered: %s",
+                         typeName.constData());
+            return false;
+        }
+        m_holdsPythonObjects |= type == pythonType;
+        m_types << type;
+        m_objectPointers << objectPointer;
+    }
+    m_values.fill(0, m_types.size());
+
+    bool connected;
+    Py_BEGIN_ALLOW_THREADS
+    connected = QMetaObject::connect(m_source, m_signalIndex, this, slotTableIndex(signal.methodSignature()), Qt::DirectConnection)
+                && QMetaObject::connect(m_source, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID, Qt::DirectConnection);
+    Py_END_ALLOW_THREADS
+    if (connected)
+        coalescedReceivers().insert(CoalescedKey(m_source, m_signalIndex), this);
+    return connected;
+}
+
+void CoalescedReceiver::disconnect()
+{
+    QMetaMethod signal = m_source->metaObject()->method(m_signalIndex);
+    coalescedReceivers().remove(CoalescedKey(m_source, m_signalIndex), this);
+    Py_BEGIN_ALLOW_THREADS
+    QMetaObject::disconnect(m_source, m_signalIndex, this, slotTableIndex(signal.methodSignature()));
+    QMetaObject::disconnect(m_source, DESTROY_SIGNAL_ID, this, DESTROY_SLOT_ID);
+    Py_END_ALLOW_THREADS
+
+    // nothing is delivered after the disconnection
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending = false;
+    }
+    // the timer can only be stopped from the thread of the receiver, elsewhere it is left to
+    // the destructor, which deleteLater() runs in that thread
+    if (thread() == QThread::currentThread())
+        m_timer.stop();
+    deleteLater();
+}
+
+GlobalReceiverV2* CoalescedReceiver::receiver() const
+{
+    return static_cast<GlobalReceiverV2*>(m_receiver.data());
+}
+
+const QMetaObject* CoalescedReceiver::metaObject() const
+{
+    return slotTable().metaObject.update();
+}
+
+int CoalescedReceiver::qt_metacall(QMetaObject::Call call, int id, void** args)
+{
+    Q_ASSERT(call == QMetaObject::InvokeMetaMethod);
+
+    if (id == DESTROY_SLOT_ID) {
+        // the global receiver drops the references linked to the source by itself
+        Shiboken::GilState gil;
+        coalescedReceivers().remove(CoalescedKey(m_source, m_signalIndex), this);
+        m_source = 0;
+        deleteLater();
+    } else {
+        store(args);
+    }
+    return -1;
+}
+
+void CoalescedReceiver::store(void** args)
+{
+    // runs on the thread of the emission, possibly without the GIL
+    QScopedPointer<Shiboken::GilState> gil(m_holdsPythonObjects ? new Shiboken::GilState : 0);
+    QMutexLocker locker(&m_mutex);
+    clearValues(m_values);
+    for (int i = 0; i < m_types.size(); ++i)
+        m_values[i] = copyValue(i, args[i + 1]);
+    if (m_pending)
+        return;
+    m_pending = true;
+    locker.unlock();
+    QCoreApplication::postEvent(this, new QEvent(deliverEventType()));
+}
+
+bool CoalescedReceiver::event(QEvent* event)
+{
+    if (event->type() == deliverEventType()) {
+        qint64 remaining = m_interval && m_lastDelivery.isValid() ? m_interval - m_lastDelivery.elapsed() : 0;
+        if (remaining > 0)
+            m_timer.start(remaining, this);
+        else
+            deliver();
+        return true;
+    }
+    if (event->type() == QEvent::Timer && static_cast<QTimerEvent*>(event)->timerId() == m_timer.timerId()) {
+        m_timer.stop();
+        deliver();
+        return true;
+    }
+    return QObject::event(event);
+}
+
+void CoalescedReceiver::deliver()
+{
+    QVector<void*> values;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_pending)
+            return;
+        values = m_values;
+        m_values.fill(0);
+        m_pending = false;
+    }
+    m_lastDelivery.start();
+
+    if (m_receiver) {
+        QVarLengthArray<void*, 11> args(values.size() + 1);
+        // QObject arguments deleted since the emission are delivered as null pointers
+        QVarLengthArray<QObject*, 11> objects(values.size());
+        args[0] = 0;
+        for (int i = 0; i < values.size(); ++i) {
+            if (m_objectPointers[i]) {
+                objects[i] = static_cast<QPointer<QObject>*>(values[i])->data();
+                args[i + 1] = &objects[i];
+            } else {
+                args[i + 1] = values[i];
+            }
+        }
+        m_receiver->qt_metacall(QMetaObject::InvokeMetaMethod, m_slotIndex, args.data());
+    }
+
+    QScopedPointer<Shiboken::GilState> gil(m_holdsPythonObjects ? new Shiboken::GilState : 0);
+    clearValues(values);
+}
+
+void* CoalescedReceiver::copyValue(int index, void* value) const
+{
+    if (m_objectPointers[index])
+        return new QPointer<QObject>(*static_cast<QObject**>(value));
+    return QMetaType::create(m_types[index], value);
+}
+
+void CoalescedReceiver::clearValues(QVector<void*>& values)
+{
+    for (int i = 0; i < values.size(); ++i) {
+        if (!values[i])
+            continue;
+        if (m_objectPointers[i])
+            delete static_cast<QPointer<QObject>*>(values[i]);
+        else
+            QMetaType::destroy(m_types[i], values[i]);
+        values[i] = 0;
+    }
+}
@@ -26,11 +26,18 @@
 #include <sbkpython.h>
 #include <QObject>
 #include <QHash>
+#include <QPair>
 #include <QSet>
 #include <QSharedPointer>
 #include <QLinkedList>
 #include <QByteArray>
 
+#include <QMutex>
+#include <QPointer>
+#include <QVector>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+
 #include "dynamicqmetaobject.h"
 
 namespace PySide
@@ -39,7 +46,12 @@ namespace PySide
 class DynamicSlotDataV2;
 class GlobalReceiverV2;
 
-typedef QSharedPointer< QMap<QByteArray, GlobalReceiverV2*> >  SharedMap;
+/**
+ * Identity of a Python callback: the (function, self) pointers of a method, or the callable
+ * object itself when it isn't bound to an instance.
+ **/
+typedef QPair<const void*, const void*> GlobalReceiverKey;
+typedef QSharedPointer< QHash<GlobalReceiverKey, GlobalReceiverV2*> >  SharedMap;
 
 /**
  * A class used to make the link between the C++ Signal/Slot and Python callback
@@ -69,7 +81,8 @@ public:
     const QMetaObject* metaObject() const;
 
     /**
-     * Add a extra slot to this object
+     * Add a extra slot to this object, the slots live in a metaobject shared by all
+     * GlobalReceiverV2 objects and only the arguments of the signature are taken into account
      *
      * @param   signature   The signature of the slot to be added
      * @return  The index of this slot on metaobject
@@ -77,7 +90,8 @@ public:
     int addSlot(const char* signature);
 
     /**
-     * Notify to GlobalReceiver about when a new connection was made
+     * Notify to GlobalReceiver about when a new connection was made, the connection
+     * used to track the destruction of the last linked object is moved after it
      **/
     void notify();
 
@@ -104,28 +118,104 @@ public:
     int refCount(const QObject* link) const;
 
     /**
-     * Use to retrive the unique hash of this GlobalReceiver object
+     * Return the number of GlobalReceiverV2 objects holding references linked to \p link
+     **/
+    static int linkedReceivers(const QObject* link);
+
+    /**
+     * Use to retrive the unique key of this GlobalReceiver object
      *
-     * @return  a string with a unique id based on GlobalReceiver contents
+     * @return  the identity of the callback called by this GlobalReceiver
      **/
-    QByteArray hash() const;
+    GlobalReceiverKey key() const;
 
     /**
-     * Use to retrive the unique hash of the PyObject based on GlobalReceiver rules
+     * Use to retrive the unique key of the PyObject based on GlobalReceiver rules
      *
-     * @param   callback The Python callable object used to calculate the id
-     * @return  a string with a unique id based on GlobalReceiver contents
+     * @param   callback The Python callable object used to calculate the key
+     * @return  the identity of the callback, without touching Python hashes or strings
      **/
-    static QByteArray hash(PyObject* callback);
+    static GlobalReceiverKey key(PyObject* callback);
 
 private:
-    DynamicQMetaObject m_metaObject;
     DynamicSlotDataV2 *m_data;
-    QList<const QObject*> m_refs;
-    int m_ref;
+    QHash<const QObject*, int> m_refs; // references held by each linked object, key 0 holds the unlinked ones
+    int m_ref; // total of references
+    const QObject* m_lastLink;
     SharedMap m_sharedMap;
 };
 
+/**
+ * Receiver of a coalesced connection: it keeps a copy of the arguments of the last emission
+ * of one signal and hands them to a GlobalReceiverV2 slot at most once per event loop
+ * iteration, or once every interval milliseconds.
+ * This class is used internally by SignalManager
+ **/
+class CoalescedReceiver : public QObject
+{
+public:
+    /**
+     * Create a receiver which delivers the arguments of 'signalIndex' to 'slotIndex' of 'receiver'
+     *
+     * @param   source      The object emitting the signal, its destruction deletes this receiver
+     * @param   signalIndex The index of the signal on source's metaobject
+     * @param   receiver    The GlobalReceiverV2 of the Python callback
+     * @param   slotIndex   The index of the callback slot on receiver's metaobject
+     * @param   interval    Minimum time between two deliveries in milliseconds, 0 for every loop iteration
+     **/
+    CoalescedReceiver(QObject* source, int signalIndex, GlobalReceiverV2* receiver, int slotIndex, int interval);
+    ~CoalescedReceiver();
+
+    /**
+     * Connect the signal to this receiver. QObject arguments are kept with a QPointer until
+     * they are delivered, other pointers are refused as they may dangle by then.
+     *
+     * @return  false with a Python TypeError set if the signal arguments can not be copied
+     **/
+    bool connect();
+
+    /**
+     * Disconnect the signal from this receiver and delete it later
+     **/
+    void disconnect();
+
+    GlobalReceiverV2* receiver() const;
+
+    /**
+     * Find the coalesced receiver connecting 'signalIndex' of 'source' to 'callback'
+     *
+     * @return  The receiver or 0 if there is no such connection
+     **/
+    static CoalescedReceiver* find(const QObject* source, int signalIndex, PyObject* callback);
+
+    /**
+     * Reimplemented function from QObject
+     **/
+    int qt_metacall(QMetaObject::Call call, int id, void** args);
+    const QMetaObject* metaObject() const;
+    bool event(QEvent* event);
+
+private:
+    void store(void** args);
+    void deliver();
+    void* copyValue(int index, void* value) const;
+    void clearValues(QVector<void*>& values);
+
+    QObject* m_source;
+    int m_signalIndex;
+    QPointer<QObject> m_receiver;
+    int m_slotIndex;
+    int m_interval;
+    QVector<int> m_types;
+    QVector<bool> m_objectPointers; // arguments stored as QPointer<QObject>
+    bool m_holdsPythonObjects;
+    QMutex m_mutex;
+    QVector<void*> m_values; // copies of the last emitted arguments, guarded by m_mutex
+    bool m_pending;
+    QBasicTimer m_timer;
+    QElapsedTimer m_lastDelivery;
+};
+
 }
 
 #endif
@@ -0,0 +1,324 @@
+/*
+ * This file is part of the PySide project.
+ *
+ * Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "invocationplan_p.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadStorage>
+#include <gilstate.h>
+#include <sbkstring.h>
+#include <cstring>
+
+namespace PySide
+{
+
+// Plans are grouped by the metaobject which declares the method, so all plans of a
+// dynamic metaobject can be dropped at once when it is rebuilt or destroyed.
+class InvocationPlanCache
+{
+public:
+    typedef QHash<int, QSharedPointer<const InvocationPlan> > PlanHash;
+
+    // Plans are released out of the lock: their destructor takes the GIL, while get() is
+    // called with the GIL held and then takes the lock.
+    ~InvocationPlanCache()
+    {
+        QHash<const QMetaObject*, PlanHash> plans;
+        QMutexLocker locker(&m_mutex);
+        plans.swap(m_plans);
+        locker.unlock();
+    }
+
+    QSharedPointer<const InvocationPlan> get(const QMetaMethod& method)
+    {
+        QMutexLocker locker(&m_mutex);
+        PlanHash& plans = m_plans[method.enclosingMetaObject()];
+        QSharedPointer<const InvocationPlan>& plan = plans[method.methodIndex()];
+        if (!plan)
+            plan = QSharedPointer<const InvocationPlan>(new InvocationPlan(method), &InvocationPlan::destroy);
+        return plan;
+    }
+
+    void invalidate(const QMetaObject* metaObject)
+    {
+        PlanHash plans;
+        QMutexLocker locker(&m_mutex);
+        QHash<const QMetaObject*, PlanHash>::iterator it = m_plans.find(metaObject);
+        if (it == m_plans.end())
+            return;
+        plans.swap(it.value());
+        m_plans.erase(it);
+        locker.unlock();
+    }
+
+private:
+    QMutex m_mutex;
+    QHash<const QMetaObject*, PlanHash> m_plans;
+};
+
+static InvocationPlanCache planCache;
+
+InvocationPlan::InvocationPlan(const QMetaMethod& method)
+    : m_name(method.name()), m_pythonName(0), m_returnConverter(0), m_returnTypeId(0)
+{
+    m_isShortCircuit = std::strchr(method.methodSignature().constData(), '(') == 0;
+    m_parameterTypes = method.parameterTypes();
+    foreach (const QByteArray& type, m_parameterTypes) {
+        m_parameterConverters << new Shiboken::Conversions::SpecificConverter(type.constData());
+        m_parameterTypeIds << QMetaType::type(type.constData());
+    }
+
+    const char* returnType = method.typeName();
+    if (returnType && std::strcmp("", returnType) && std::strcmp("void", returnType)) {
+        m_returnType = returnType;
+        m_returnTypeId = QMetaType::type(returnType);
+        m_returnConverter = new Shiboken::Conversions::SpecificConverter(returnType);
+    }
+}
+
+InvocationPlan::~InvocationPlan()
+{
+    qDeleteAll(m_parameterConverters);
+    delete m_returnConverter;
+    if (m_pythonName && Py_IsInitialized()) {
+        Shiboken::GilState gil;
+        Py_DECREF(m_pythonName);
+    }
+}
+
+void InvocationPlan::destroy(const InvocationPlan* plan)
+{
+    delete plan;
+}
+
+QSharedPointer<const InvocationPlan> InvocationPlan::get(const QMetaMethod& method)
+{
+    return planCache.get(method);
+}
+
+void InvocationPlan::invalidate(const QMetaObject* metaObject)
+{
+    planCache.invalidate(metaObject);
+}
+
+PyObject* InvocationPlan::pythonName() const
+{
+    if (!m_pythonName)
+        m_pythonName = Shiboken::String::fromCString(m_name.constData());
+    return m_pythonName;
+}
+
+// Returns \p converter, or if its type was unknown when the plan was made, the converter of
+// \p type found now, owned by \p retry
+static Shiboken::Conversions::SpecificConverter* resolveConverter(Shiboken::Conversions::SpecificConverter* converter,
+                                                                  const QByteArray& type,
+                                                                  QScopedPointer<Shiboken::Conversions::SpecificConverter>& retry)
+{
+    if (*converter)
+        return converter;
+    retry.reset(new Shiboken::Conversions::SpecificConverter(type.constData()));
+    return retry.data();
+}
+
+Shiboken::Conversions::SpecificConverter* InvocationPlan::returnConverter(QScopedPointer<Shiboken::Conversions::SpecificConverter>& retry) const
+{
+    if (!m_returnConverter)
+        return 0;
+    Shiboken::Conversions::SpecificConverter* converter = resolveConverter(m_returnConverter, m_returnType, retry);
+    return *converter ? converter : 0;
+}
+
+PyObject* InvocationPlan::argumentsToPython(void** args) const
+{
+    int argsSize = m_parameterConverters.size();
+    PyObject* preparedArgs = PyTuple_New(argsSize);
+
+    for (int i = 0; i < argsSize; ++i) {
+        QScopedPointer<Shiboken::Conversions::SpecificConverter> retry;
+        Shiboken::Conversions::SpecificConverter* converter = resolveConverter(m_parameterConverters[i], m_parameterTypes[i], retry);
+        if (*converter) {
+            PyTuple_SET_ITEM(preparedArgs, i, converter->toPython(args[i+1]));
+        } else {
+            PyErr_Format(PyExc_TypeError, "Can't call meta function because I have no idea how to handle %s",
+                         m_parameterTypes[i].constData());
+            Py_DECREF(preparedArgs);
+            return 0;
+        }
+    }
+    return preparedArgs;
+}
+
+static bool prepareValue(Shiboken::Conversions::SpecificConverter* converter, int typeId, const QByteArray& typeName,
+                         QVariant* value, void** cppArg)
+{
+    if (!*converter) {
+        PyErr_Format(PyExc_TypeError, "Unknown type used to call meta function (that may be a signal): %s", typeName.constData());
+        return false;
+    }
+
+    if (!Shiboken::Conversions::pythonTypeIsObjectType(*converter)) {
+        if (!typeId) {
+            PyErr_Format(PyExc_TypeError, "Value types used on meta functions (including signals) need to be "
+                                          "registered on meta type: %s", typeName.constData());
+            return false;
+        }
+        *value = QVariant(typeId, (void*) 0);
+    }
+    *cppArg = value->data();
+    return true;
+}
+
+bool InvocationPlan::argumentsToCpp(PyObject* sequence, QVariant* values, void** cppArgs) const
+{
+    cppArgs[0] = 0;
+    if (hasReturnValue()) {
+        // unknown return types are reported as unknown arguments, like any other type
+        QScopedPointer<Shiboken::Conversions::SpecificConverter> retry;
+        Shiboken::Conversions::SpecificConverter* converter = resolveConverter(m_returnConverter, m_returnType, retry);
+        int typeId = m_returnTypeId ? m_returnTypeId : QMetaType::type(m_returnType.constData());
+        if (!prepareValue(converter, typeId, m_returnType, &values[0], &cppArgs[0]))
+            return false;
+    }
+
+    for (int i = 0, max = m_parameterConverters.size(); i < max; ++i) {
+        QScopedPointer<Shiboken::Conversions::SpecificConverter> retry;
+        Shiboken::Conversions::SpecificConverter* converter = resolveConverter(m_parameterConverters[i], m_parameterTypes[i], retry);
+        int typeId = m_parameterTypeIds[i] ? m_parameterTypeIds[i] : QMetaType::type(m_parameterTypes[i].constData());
+        if (!prepareValue(converter, typeId, m_parameterTypes[i], &values[i + 1], &cppArgs[i + 1]))
+            return false;
+
+        PyObject* item = PySequence_Fast_GET_ITEM(sequence, i);
+        if (typeId == QVariant::String) {
+            QString tmp;
+            converter->toCpp(item, &tmp);
+            values[i + 1] = tmp;
+        } else {
+            converter->toCpp(item, cppArgs[i + 1]);
+        }
+    }
+    return true;
+}
+
+// Builtin values which Python can't change in place
+static bool isImmutable(PyObject* value)
+{
+    if (value == Py_None || PyBool_Check(value) || PyLong_CheckExact(value) || PyFloat_CheckExact(value)
+        || PyComplex_CheckExact(value) || PyUnicode_CheckExact(value) || PyBytes_CheckExact(value)) {
+        return true;
+    }
+#ifndef IS_PY3K
+    if (PyInt_CheckExact(value))
+        return true;
+#endif
+    if (PyTuple_CheckExact(value)) {
+        for (Py_ssize_t i = 0, max = PyTuple_GET_SIZE(value); i < max; ++i) {
+            if (!isImmutable(PyTuple_GET_ITEM(value, i)))
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool InvocationPlan::canShareArguments(PyObject* arguments) const
+{
+    for (Py_ssize_t i = 0, max = PyTuple_GET_SIZE(arguments); i < max; ++i) {
+        // pointers to object types are converted to the same wrapper for every receiver
+        Shiboken::Conversions::SpecificConverter* converter = m_parameterConverters[i];
+        if (!(*converter && Shiboken::Conversions::pythonTypeIsObjectType(*converter))
+            && !isImmutable(PyTuple_GET_ITEM(arguments, i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The innermost emission scope of each thread
+struct EmissionScopeStack
+{
+    EmissionScopeStack() : current(0) {}
+    EmissionScope* current;
+};
+
+static QThreadStorage<EmissionScopeStack> emissionScopes;
+
+// Returns true if the first \p count parameters of \p plan have the types listed in \p types
+static bool sameParameterTypes(const InvocationPlan* plan, const QList<QByteArray>& types, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        if (plan->parameterType(i) != types[i])
+            return false;
+    }
+    return true;
+}
+
+EmissionScope::EmissionScope(void** args)
+    : m_args(args), m_arguments(0)
+{
+    EmissionScopeStack& stack = emissionScopes.localData();
+    m_previous = stack.current;
+    stack.current = this;
+}
+
+EmissionScope::~EmissionScope()
+{
+    emissionScopes.localData().current = m_previous;
+    if (m_arguments) {
+        Shiboken::GilState gil;
+        Py_DECREF(m_arguments);
+    }
+}
+
+PyObject* EmissionScope::arguments(const InvocationPlan* plan, void** args)
+{
+    EmissionScope* scope = emissionScopes.hasLocalData() ? emissionScopes.localData().current : 0;
+    if (!scope || scope->m_args != args)
+        return plan->argumentsToPython(args);
+
+    int count = plan->parameterCount();
+    if (scope->m_arguments) {
+        int cachedCount = scope->m_parameterTypes.size();
+        if (count <= cachedCount && sameParameterTypes(plan, scope->m_parameterTypes, count)) {
+            if (count == cachedCount) {
+                Py_INCREF(scope->m_arguments);
+                return scope->m_arguments;
+            }
+            return PyTuple_GetSlice(scope->m_arguments, 0, count);
+        }
+        // Only a receiver taking more arguments than the cached ones replaces them
+        if (count < cachedCount || !sameParameterTypes(plan, scope->m_parameterTypes, cachedCount))
+            return plan->argumentsToPython(args);
+    }
+
+    PyObject* arguments = plan->argumentsToPython(args);
+    if (arguments && plan->canShareArguments(arguments)) {
+        Py_XDECREF(scope->m_arguments);
+        Py_INCREF(arguments);
+        scope->m_arguments = arguments;
+        scope->m_parameterTypes = plan->parameterTypes();
+    }
+    return arguments;
+}
+
+} //namespace PySide
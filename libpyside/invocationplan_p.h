@@ -0,0 +1,163 @@
+/*
+ * This file is part of the PySide project.
+ *
+ * Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PYSIDE_INVOCATIONPLAN_P_H
+#define PYSIDE_INVOCATIONPLAN_P_H
+
+#include <sbkpython.h>
+#include <sbkconverter.h>
+#include <QByteArray>
+#include <QList>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QVector>
+#include <QVariant>
+#include <QMetaMethod>
+
+namespace PySide
+{
+
+/**
+ * The converters needed to move the arguments of a QMetaMethod between C++ and Python.
+ *
+ * Resolving a converter from a type name costs a string hash and a registry lookup, so
+ * this is done once per (metaobject, method index) and the plan is reused on every call.
+ * Plans of a DynamicQMetaObject are dropped with invalidate() whenever its data changes,
+ * the ones still in use by a call are deleted when it releases them.
+ * Types unknown when the plan is made are looked up again on each use, they may be
+ * registered later by an import.
+ **/
+class InvocationPlan
+{
+public:
+    /**
+     * Return the cached plan for \p method, creating it on the first call.
+     **/
+    static QSharedPointer<const InvocationPlan> get(const QMetaMethod& method);
+
+    /**
+     * Drop all plans created for methods declared on \p metaObject.
+     **/
+    static void invalidate(const QMetaObject* metaObject);
+
+    bool isShortCircuit() const { return m_isShortCircuit; }
+
+    /**
+     * The method name as a Python string, created on the first call. Requires the GIL.
+     * \return A borrowed reference.
+     **/
+    PyObject* pythonName() const;
+
+    int parameterCount() const { return m_parameterTypes.size(); }
+    const QByteArray& parameterType(int index) const { return m_parameterTypes[index]; }
+    const QList<QByteArray>& parameterTypes() const { return m_parameterTypes; }
+
+    /**
+     * Convert the C++ arguments found in \p args (args[0] is the return value) to a new Python tuple.
+     * \return A new reference or 0 with a Python TypeError set.
+     **/
+    PyObject* argumentsToPython(void** args) const;
+
+    /**
+     * Convert the Python arguments of \p sequence (a result of PySequence_Fast) to C++.
+     * The values are stored on \p values and \p cppArgs receives pointers to them, both must have
+     * room for parameterCount() + 1 items, the first one is used for the return value.
+     * \return false with a Python TypeError set if some argument can not be converted.
+     **/
+    bool argumentsToCpp(PyObject* sequence, QVariant* values, void** cppArgs) const;
+
+    /**
+     * Return true if \p arguments, a tuple made by argumentsToPython(), can be given to several
+     * receivers: it must only hold wrappers of object types and values Python can't change in place.
+     **/
+    bool canShareArguments(PyObject* arguments) const;
+
+    bool hasReturnValue() const { return !m_returnType.isEmpty(); }
+    const QByteArray& returnType() const { return m_returnType; }
+
+    /**
+     * The converter for the return type, 0 if the method returns void or the type is unknown.
+     * \param retry Owns the converter returned when the type wasn't known as the plan was made.
+     **/
+    Shiboken::Conversions::SpecificConverter* returnConverter(QScopedPointer<Shiboken::Conversions::SpecificConverter>& retry) const;
+
+private:
+    explicit InvocationPlan(const QMetaMethod& method);
+    ~InvocationPlan();
+
+    // the deleter of the shared plans, which keeps the destructor private
+    static void destroy(const InvocationPlan* plan);
+
+    // disable copy
+    InvocationPlan(const InvocationPlan&);
+    InvocationPlan& operator=(const InvocationPlan&);
+
+    bool m_isShortCircuit;
+    QByteArray m_name;
+    mutable PyObject* m_pythonName;
+    QList<QByteArray> m_parameterTypes;
+    QList<Shiboken::Conversions::SpecificConverter*> m_parameterConverters;
+    QVector<int> m_parameterTypeIds;
+    QByteArray m_returnType;
+    Shiboken::Conversions::SpecificConverter* m_returnConverter;
+    int m_returnTypeId;
+
+    friend class InvocationPlanCache;
+};
+
+/**
+ * Shares the Python arguments built for one signal emission between all its Python receivers.
+ *
+ * Create one on the stack around QMetaObject::activate; while it is the innermost scope of the
+ * current thread, arguments() converts the emission arguments only for the first receiver and
+ * hands the same tuple to the next ones. Receivers with truncated signatures get a slice of it.
+ * Arguments a receiver could modify, such as lists or value type wrappers, are converted again
+ * for each receiver.
+ **/
+class EmissionScope
+{
+public:
+    explicit EmissionScope(void** args);
+    ~EmissionScope();
+
+    /**
+     * Return the Python arguments for a receiver described by \p plan, the emission scope
+     * is only used when \p args belongs to it, otherwise they are converted as usual.
+     * \return A new reference or 0 with a Python error set.
+     **/
+    static PyObject* arguments(const InvocationPlan* plan, void** args);
+
+private:
+    // disable copy
+    EmissionScope(const EmissionScope&);
+    EmissionScope& operator=(const EmissionScope&);
+
+    void** m_args;
+    EmissionScope* m_previous;
+    // the types of m_arguments, a receiver may delete the plan they were converted with
+    QList<QByteArray> m_parameterTypes;
+    PyObject* m_arguments;
+};
+
+} //namespace PySide
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * This file is part of the PySide project.
+ *
+ * Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "metamethodindex_p.h"
+
+#include <QHash>
+#include <QMetaMethod>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace PySide
+{
+
+struct MethodNames
+{
+    MethodNames() : methodCount(0) {}
+    int methodCount; // methods already indexed
+    QHash<QByteArray, QVector<int> > indexes;
+};
+
+class MetaMethodIndexCache
+{
+public:
+    ~MetaMethodIndexCache()
+    {
+        qDeleteAll(m_names);
+    }
+
+    QVector<int> methods(const QMetaObject* metaObject, const QByteArray& name)
+    {
+        QMutexLocker locker(&m_mutex);
+        MethodNames*& names = m_names[metaObject];
+        if (!names)
+            names = new MethodNames;
+
+        // methods are only appended while the index is valid
+        for (int i = names->methodCount, max = metaObject->methodCount(); i < max; ++i)
+            names->indexes[metaObject->method(i).name()].append(i);
+        names->methodCount = qMax(names->methodCount, metaObject->methodCount());
+
+        return names->indexes.value(name);
+    }
+
+    void invalidate(const QMetaObject* metaObject)
+    {
+        QMutexLocker locker(&m_mutex);
+        delete m_names.take(metaObject);
+    }
+
+private:
+    QMutex m_mutex;
+    QHash<const QMetaObject*, MethodNames*> m_names;
+};
+
+static MetaMethodIndexCache indexCache;
+
+QVector<int> MetaMethodIndex::methods(const QMetaObject* metaObject, const QByteArray& name)
+{
+    return indexCache.methods(metaObject, name);
+}
+
+void MetaMethodIndex::invalidate(const QMetaObject* metaObject)
+{
+    indexCache.invalidate(metaObject);
+}
+
+} //namespace PySide
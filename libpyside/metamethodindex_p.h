@@ -0,0 +1,56 @@
+/*
+ * This file is part of the PySide project.
+ *
+ * Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PYSIDE_METAMETHODINDEX_P_H
+#define PYSIDE_METAMETHODINDEX_P_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QMetaObject>
+
+namespace PySide
+{
+
+/**
+ * The indexes of the methods of a QMetaObject, grouped by method name.
+ *
+ * The index of a metaobject is built on the first lookup and shared by all its instances.
+ * Methods appended to a DynamicQMetaObject are picked up on the next lookup, any other
+ * change of its methods must drop the index with invalidate().
+ **/
+class MetaMethodIndex
+{
+public:
+    /**
+     * Return the indexes of the methods of \p metaObject called \p name, in increasing order.
+     **/
+    static QVector<int> methods(const QMetaObject* metaObject, const QByteArray& name);
+
+    /**
+     * Drop the index built for \p metaObject.
+     **/
+    static void invalidate(const QMetaObject* metaObject);
+};
+
+} //namespace PySide
+
+#endif
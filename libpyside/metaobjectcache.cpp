@@ -0,0 +1,267 @@
+/*
+ * This file is part of the PySide project.
+ *
+ * Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "metaobjectcache_p.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QMetaType>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstdlib>
+#include <cstring>
+
+// The entries are the raw meta data, only valid for the Qt build which wrote them
+#define CACHE_MAGIC 0x50534d4f // PSMO
+#define CACHE_FORMAT_VERSION 1
+
+namespace PySide
+{
+
+struct CacheHeader
+{
+    quint32 magic;
+    quint32 formatVersion;
+    quint32 qtVersion;
+    quint32 pointerSize;
+    quint32 dataSize;
+    quint32 stringDataSize;
+};
+
+static QString cacheDirectory()
+{
+    static QString directory;
+    static bool initialized = false;
+    if (!initialized) {
+        QByteArray value = qgetenv("PYSIDE_METAOBJECT_CACHE");
+        if (value == "1")
+            directory = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/PySide2/metaobjects");
+        else if (!value.isEmpty() && value != "0")
+            directory = QFile::decodeName(value);
+        initialized = true;
+    }
+    return directory;
+}
+
+static QString entryPath(const QByteArray& key)
+{
+    return cacheDirectory() + QLatin1Char('/') + QFile::decodeName(key);
+}
+
+bool MetaObjectCache::isEnabled()
+{
+    return !cacheDirectory().isEmpty();
+}
+
+QByteArray MetaObjectCache::key(const QByteArray& qualName, const QByteArray& contents)
+{
+    QByteArray key = qualName;
+    for (int i = 0; i < key.size(); ++i) {
+        char c = key[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_'))
+            key[i] = '_';
+    }
+    key += '-';
+    key += QCryptographicHash::hash(contents, QCryptographicHash::Sha1).toHex();
+    return key;
+}
+
+// The layout of the entries is the one written by DynamicQMetaObject, see qmetaobject_p.h
+enum {
+    MetaDataRevision = 7,
+    HeaderLength = 14,
+    MethodRevisioned = 0x80,
+    PropertyRevisioned = 0x00800000,
+    PropertyNotify = 0x00400000,
+    UnresolvedType = 0x80000000,
+    TypeNameIndexMask = 0x7FFFFFFF
+};
+
+// Checks the indexes of a loaded entry, Qt uses them without any check. The files may have
+// been truncated or changed by anybody able to write to the cache directory.
+class MetaDataValidator
+{
+public:
+    MetaDataValidator(const uint* data, uint dataSize, const char* stringData, uint stringDataSize)
+        : m_data(data), m_dataSize(dataSize), m_stringData(stringData), m_stringDataSize(stringDataSize),
+          m_stringCount(0)
+    {
+        // the headers of the strings come first and the first string is at the start of the
+        // characters, so the offset of the first header is the size of the headers array
+        if (stringDataSize >= sizeof(QByteArrayData)) {
+            qptrdiff headersSize = reinterpret_cast<const QByteArrayData*>(stringData)->offset;
+            if (headersSize > 0 && quint64(headersSize) <= stringDataSize && headersSize % sizeof(QByteArrayData) == 0)
+                m_stringCount = headersSize / sizeof(QByteArrayData);
+        }
+    }
+
+    bool isValid() const
+    {
+        if (m_dataSize < HeaderLength + 1 || m_data[m_dataSize - 1] != 0
+            || m_data[0] != MetaDataRevision || !isString(m_data[1])
+            || m_data[8] != 0 || m_data[10] != 0 || m_data[13] > m_data[4]) {
+            return false;
+        }
+
+        uint classInfoCount = m_data[2];
+        if (!isRange(m_data[3], classInfoCount, 2))
+            return false;
+        for (uint i = 0; i < classInfoCount * 2; ++i) {
+            if (!isString(m_data[m_data[3] + i]))
+                return false;
+        }
+
+        uint methodCount = m_data[4];
+        if (!isRange(m_data[5], methodCount, 5))
+            return false;
+        for (uint i = 0; i < methodCount; ++i) {
+            const uint* method = m_data + m_data[5] + i * 5;
+            if (!isString(method[0]) || !isString(method[3]) || (method[4] & MethodRevisioned)
+                || !isParameters(method[2], method[1])) {
+                return false;
+            }
+        }
+
+        uint propertyCount = m_data[6];
+        if (!isRange(m_data[7], propertyCount, 4))
+            return false;
+        for (uint i = 0; i < propertyCount; ++i) {
+            const uint* property = m_data + m_data[7] + i * 3;
+            if (!isString(property[0]) || !isTypeInfo(property[1]) || (property[2] & PropertyRevisioned))
+                return false;
+            if ((property[2] & PropertyNotify) && m_data[m_data[7] + propertyCount * 3 + i] >= methodCount)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    // \p count items of \p size uints starting at \p index fit in the data
+    bool isRange(uint index, uint count, uint size) const
+    {
+        if (!count)
+            return true;
+        return index >= HeaderLength && index < m_dataSize && quint64(count) * size <= m_dataSize - index;
+    }
+
+    bool isString(uint index) const
+    {
+        if (index >= m_stringCount)
+            return false;
+        const QByteArrayData* header = reinterpret_cast<const QByteArrayData*>(m_stringData) + index;
+        qptrdiff start = index * sizeof(QByteArrayData) + header->offset;
+        // the characters are followed by a '\0'
+        return header->ref.isStatic() && header->size >= 0
+            && start >= qptrdiff(m_stringCount * sizeof(QByteArrayData))
+            && quint64(start) + header->size < m_stringDataSize;
+    }
+
+    // a builtin type id or the index of the name of a type unknown to QMetaType at build time
+    bool isTypeInfo(uint typeInfo) const
+    {
+        return typeInfo & UnresolvedType ? isString(typeInfo & TypeNameIndexMask) : typeInfo < QMetaType::User;
+    }
+
+    // the return and parameter types of a method with \p argc arguments, then their names
+    bool isParameters(uint index, uint argc) const
+    {
+        if (argc >= m_dataSize || !isRange(index, 1 + argc * 2, 1))
+            return false;
+        for (uint i = 0; i <= argc; ++i) {
+            if (!isTypeInfo(m_data[index + i]))
+                return false;
+        }
+        for (uint i = 1; i <= argc; ++i) {
+            if (!isString(m_data[index + argc + i]))
+                return false;
+        }
+        return true;
+    }
+
+    const uint* m_data;
+    uint m_dataSize;
+    const char* m_stringData;
+    uint m_stringDataSize;
+    uint m_stringCount;
+};
+
+bool MetaObjectCache::load(const QByteArray& key, QMetaObject* metaObj, int* dataSize, int* stringDataSize)
+{
+    QFile file(entryPath(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    CacheHeader header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+        || header.magic != CACHE_MAGIC
+        || header.formatVersion != CACHE_FORMAT_VERSION
+        || header.qtVersion != QT_VERSION
+        || header.pointerSize != sizeof(void*)
+        || file.size() != qint64(sizeof(header) + header.dataSize * sizeof(uint) + header.stringDataSize)) {
+        return false;
+    }
+
+    uint* data = reinterpret_cast<uint*>(std::malloc(header.dataSize * sizeof(uint)));
+    char* stringData = reinterpret_cast<char*>(std::malloc(header.stringDataSize));
+    if (!data || !stringData
+        || file.read(reinterpret_cast<char*>(data), header.dataSize * sizeof(uint)) != qint64(header.dataSize * sizeof(uint))
+        || file.read(stringData, header.stringDataSize) != qint64(header.stringDataSize)
+        || !MetaDataValidator(data, header.dataSize, stringData, header.stringDataSize).isValid()) {
+        std::free(data);
+        std::free(stringData);
+        return false;
+    }
+
+    std::free(const_cast<uint*>(metaObj->d.data));
+    std::free(const_cast<QByteArrayData*>(metaObj->d.stringdata));
+    metaObj->d.data = data;
+    metaObj->d.stringdata = reinterpret_cast<const QByteArrayData*>(stringData);
+    *dataSize = header.dataSize;
+    *stringDataSize = header.stringDataSize;
+    return true;
+}
+
+void MetaObjectCache::store(const QByteArray& key, const QMetaObject* metaObj, int dataSize, int stringDataSize)
+{
+    if (!QDir().mkpath(cacheDirectory()))
+        return;
+
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.formatVersion = CACHE_FORMAT_VERSION;
+    header.qtVersion = QT_VERSION;
+    header.pointerSize = sizeof(void*);
+    header.dataSize = dataSize;
+    header.stringDataSize = stringDataSize;
+
+    // written aside and renamed, other processes never see a partial entry
+    QSaveFile file(entryPath(key));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(metaObj->d.data), dataSize * sizeof(uint));
+    file.write(reinterpret_cast<const char*>(metaObj->d.stringdata), stringDataSize);
+    file.commit();
+}
+
+} //namespace PySide
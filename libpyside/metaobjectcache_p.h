@@ -0,0 +1,66 @@
+/*
+ * This file is part of the PySide project.
+ *
+ * Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+ *
+ * Contact: PySide team <contact@pyside.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PYSIDE_METAOBJECTCACHE_P_H
+#define PYSIDE_METAOBJECTCACHE_P_H
+
+#include <QByteArray>
+#include <QMetaObject>
+
+namespace PySide
+{
+
+/**
+ * On disk cache of the meta data built for the Python classes inheriting QObject.
+ *
+ * It is disabled unless the PYSIDE_METAOBJECT_CACHE environment variable is set, to 1 for
+ * a PySide2/metaobjects directory inside the user cache directory or to any other directory.
+ * Entries are found by the qualified name of the class and a hash of everything the meta
+ * data is made of, so a changed class just misses and writes a new entry.
+ **/
+class MetaObjectCache
+{
+public:
+    static bool isEnabled();
+
+    /**
+     * Return the name of the entry of class \p qualName whose meta data is built from \p contents.
+     **/
+    static QByteArray key(const QByteArray& qualName, const QByteArray& contents);
+
+    /**
+     * Replace the data and string data of \p metaObj by the ones stored for \p key. Every count,
+     * index and string offset of the entry is checked against its sizes before it is used.
+     * \return false, leaving \p metaObj untouched, if there is no valid entry.
+     **/
+    static bool load(const QByteArray& key, QMetaObject* metaObj, int* dataSize, int* stringDataSize);
+
+    /**
+     * Store the first \p dataSize items of the data of \p metaObj and \p stringDataSize bytes
+     * of its string data for \p key. Errors are ignored, the entry is just missing next time.
+     **/
+    static void store(const QByteArray& key, const QMetaObject* metaObj, int dataSize, int stringDataSize);
+};
+
+} //namespace PySide
+
+#endif
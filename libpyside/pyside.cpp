@@ -31,6 +31,7 @@
 #include "pysidemetafunction_p.h"
 #include "pysidemetafunction.h"
 #include "dynamicqmetaobject.h"
+#include "metamethodindex_p.h"
 #include "destroylistener.h"
 
 #include <basewrapper.h>
@@ -45,7 +46,8 @@
 #include <QStack>
 #include <QCoreApplication>
 #include <QDebug>
-#include <QSharedPointer>
+#include <QHash>
+#include <QPointer>
 
 static QStack<PySide::CleanupFunction> cleanupFunctionList;
 static void* qobjectNextAddr;
@@ -65,40 +67,221 @@ void init(PyObject *module)
     SignalManager::instance();
 }
 
+namespace {
+
+// What fillQtProperties does with a keyword argument, resolved once per class
+struct KwargAction
+{
+    enum Kind { Ignore, CallSetter, LookupSetter, ConnectSignal, Invalid };
+
+    KwargAction() : kind(Invalid), setterName(0), attribute(0) {}
+
+    Kind kind;
+    PyObject* setterName;   // "setXxx", to check the attributes of the instance
+    PyObject* attribute;    // the setter found on the class, or for LookupSetter the Property if any
+    QByteArray signal;      // the signature to connect to, like "2name()"
+};
+
+struct KwargActions
+{
+    KwargActions() : versionTag(0) {}
+
+    unsigned int versionTag;
+    QHash<QByteArray, KwargAction> actions;
+};
+
+// The actions depend on the Python class, which may override setters, the metaobject and the
+// blacklist of the constructor, both static data of the bound class
+struct KwargActionsKey
+{
+    PyTypeObject* type;
+    const QMetaObject* metaObject;
+    const char** blackList;
+
+    bool operator==(const KwargActionsKey& other) const
+    {
+        return type == other.type && metaObject == other.metaObject && blackList == other.blackList;
+    }
+};
+
+inline uint qHash(const KwargActionsKey& key)
+{
+    return ::qHash(key.type) ^ ::qHash(key.metaObject) ^ ::qHash(key.blackList);
+}
+
+typedef QHash<KwargActionsKey, KwargActions> KwargActionsCache;
+
+// The actions of the bound classes, which are never deallocated, the classes made in Python
+// keep theirs in their TypeUserData. Protected by the GIL.
+static KwargActionsCache kwargActions;
+
+static void clearKwargAction(KwargAction& action)
+{
+    Py_XDECREF(action.setterName);
+    Py_XDECREF(action.attribute);
+    action = KwargAction();
+}
+
+static void clearKwargActions(KwargActions& cache)
+{
+    QHash<QByteArray, KwargAction>::iterator it = cache.actions.begin();
+    for (; it != cache.actions.end(); ++it)
+        clearKwargAction(it.value());
+    cache.actions.clear();
+}
+
+static void clearKwargActions(KwargActionsCache& cache)
+{
+    KwargActionsCache::iterator it = cache.begin();
+    for (; it != cache.end(); ++it)
+        clearKwargActions(it.value());
+    cache.clear();
+}
+
+static KwargAction resolveKwargAction(PyTypeObject* type, const QMetaObject* metaObj, PyObject* key,
+                                      const char** blackList, unsigned int blackListSize)
+{
+    KwargAction action;
+    const char* name = Shiboken::String::toCString(key);
+    if (blackListSize && std::binary_search(blackList, blackList + blackListSize, std::string(name))) {
+        action.kind = KwargAction::Ignore;
+        return action;
+    }
+
+    QByteArray propName(name);
+    if (metaObj->indexOfProperty(propName) != -1) {
+        propName[0] = std::toupper(propName[0]);
+        propName.prepend("set");
+        action.setterName = Shiboken::String::fromCString(propName.constData());
+        action.attribute = _PyType_Lookup(type, action.setterName);
+        if (action.attribute) {
+            action.kind = KwargAction::CallSetter;
+        } else {
+            // the setter may still be found by __getattr__ or in the metaobject of the instance
+            action.kind = KwargAction::LookupSetter;
+            action.attribute = _PyType_Lookup(type, key);
+            if (!PySide::Property::checkType(action.attribute))
+                action.attribute = 0;
+        }
+        Py_XINCREF(action.attribute);
+    } else {
+        propName.append("()");
+        if (metaObj->indexOfSignal(propName) != -1) {
+            action.kind = KwargAction::ConnectSignal;
+            action.signal = propName.prepend('2');
+        }
+    }
+    return action;
+}
+
+// Calls the setter found on the class as getattr(qObj, setterName)(value) would do
+static void callKwargSetter(PyObject* qObj, const KwargAction& action, PyObject* value)
+{
+    PyObject** dict = _PyObject_GetDictPtr(qObj);
+    Shiboken::AutoDecRef setter(0);
+    if (dict && *dict && PyDict_GetItem(*dict, action.setterName)) {
+        setter.reset(PyObject_GetAttr(qObj, action.setterName));
+    } else {
+        descrgetfunc get = Py_TYPE(action.attribute)->tp_descr_get;
+        if (get) {
+            setter.reset(get(action.attribute, qObj, reinterpret_cast<PyObject*>(Py_TYPE(qObj))));
+        } else {
+            Py_INCREF(action.attribute);
+            setter.reset(action.attribute);
+        }
+    }
+    if (!setter.isNull())
+        Shiboken::AutoDecRef retval(PyObject_CallFunctionObjArgs(setter, value, NULL));
+}
+
+// Sets a property whose setter isn't on the class with the full attribute lookup of the instance,
+// then with the Python property of the class
+static void lookupKwargSetter(PyObject* qObj, const KwargAction& action, PyObject* value)
+{
+    Shiboken::AutoDecRef setter(PyObject_GetAttr(qObj, action.setterName));
+    if (!setter.isNull()) {
+        Shiboken::AutoDecRef retval(PyObject_CallFunctionObjArgs(setter, value, NULL));
+        return;
+    }
+    PyErr_Clear();
+    if (action.attribute)
+        PySide::Property::setValue(reinterpret_cast<PySideProperty*>(action.attribute), qObj, value);
+}
+
+} // namespace
+
+struct TypeUserData {
+    TypeUserData(PyTypeObject* type, const QMetaObject* metaobject) : mo(type, metaobject) {}
+    // classes are deallocated with the GIL held
+    ~TypeUserData() { clearKwargActions(kwargActions); }
+    DynamicQMetaObject mo;
+    std::size_t cppObjSize;
+    KwargActionsCache kwargActions; // see fillQtProperties()
+};
+
+static KwargActionsCache& kwargActionsCache(PyTypeObject* type)
+{
+    TypeUserData* userData = reinterpret_cast<TypeUserData*>(Shiboken::ObjectType::getTypeUserData(reinterpret_cast<SbkObjectType*>(type)));
+    return userData ? userData->kwargActions : kwargActions;
+}
+
 bool fillQtProperties(PyObject* qObj, const QMetaObject* metaObj, PyObject* kwds, const char** blackList, unsigned int blackListSize)
 {
+    PyTypeObject* type = Py_TYPE(qObj);
+    KwargActionsKey cacheKey = { type, metaObj, blackList };
+    KwargActions& cache = kwargActionsCache(type)[cacheKey];
+
+    // Python changes the version tag of a class when any of its attributes, or of its bases,
+    // change, any setter found on the class may have been replaced then
+    bool cacheable = PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG);
+    if (!cacheable || cache.versionTag != type->tp_version_tag)
+        clearKwargActions(cache);
 
     PyObject *key, *value;
     Py_ssize_t pos = 0;
 
     while (PyDict_Next(kwds, &pos, &key, &value)) {
-        if (!blackListSize || !std::binary_search(blackList, blackList + blackListSize, std::string(Shiboken::String::toCString(key)))) {
-            QByteArray propName(Shiboken::String::toCString(key));
-            if (metaObj->indexOfProperty(propName) != -1) {
-                propName[0] = std::toupper(propName[0]);
-                propName.prepend("set");
-
-                Shiboken::AutoDecRef propSetter(PyObject_GetAttrString(qObj, propName.constData()));
-                if (!propSetter.isNull()) {
-                    Shiboken::AutoDecRef args(PyTuple_Pack(1, value));
-                    Shiboken::AutoDecRef retval(PyObject_CallObject(propSetter, args));
-                } else {
-                    PyObject* attr = PyObject_GenericGetAttr(qObj, key);
-                    if (PySide::Property::checkType(attr))
-                        PySide::Property::setValue(reinterpret_cast<PySideProperty*>(attr), qObj, value);
-                }
-            } else {
-                propName.append("()");
-                if (metaObj->indexOfSignal(propName) != -1) {
-                    propName.prepend('2');
-                    PySide::Signal::connect(qObj, propName, value);
-                } else {
-                    PyErr_Format(PyExc_AttributeError, "'%s' is not a Qt property or a signal", propName.constData());
-                    return false;
-                };
+        const char* rawName = Shiboken::String::toCString(key);
+        QByteArray name = QByteArray::fromRawData(rawName, std::strlen(rawName));
+        QHash<QByteArray, KwargAction>::iterator it = cache.actions.find(name);
+        if (it == cache.actions.end()) {
+            KwargAction action = resolveKwargAction(type, metaObj, key, blackList, blackListSize);
+            // the lookups done by the resolution assign a version tag to the class
+            if (!cacheable && PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
+                cacheable = true;
+                cache.versionTag = type->tp_version_tag;
             }
+            it = cache.actions.insert(QByteArray(name.constData(), name.size()), action);
+        }
+
+        // a setter may construct objects of the same class and so change the cache
+        KwargAction action = it.value();
+        Shiboken::AutoDecRef keepSetterName(action.setterName);
+        Shiboken::AutoDecRef keepAttribute(action.attribute);
+        Py_XINCREF(action.setterName);
+        Py_XINCREF(action.attribute);
+        switch (action.kind) {
+            case KwargAction::Ignore:
+                break;
+            case KwargAction::CallSetter:
+                callKwargSetter(qObj, action, value);
+                break;
+            case KwargAction::LookupSetter:
+                lookupKwargSetter(qObj, action, value);
+                break;
+            case KwargAction::ConnectSignal:
+                PySide::Signal::connect(qObj, action.signal, value);
+                break;
+            case KwargAction::Invalid:
+                PyErr_Format(PyExc_AttributeError, "'%s()' is not a Qt property or a signal", name.constData());
+                if (!cacheable)
+                    clearKwargActions(cache);
+                return false;
         }
     }
+
+    if (!cacheable)
+        clearKwargActions(cache);
     return true;
 }
 
@@ -117,6 +300,34 @@ void runCleanupFunctions()
     PySide::DestroyListener::destroy();
 }
 
+// -1 until set, then read from the environment when needed
+static int fastShutdown = -1;
+
+void setFastShutdown(bool enabled)
+{
+    fastShutdown = enabled;
+}
+
+bool isFastShutdown()
+{
+    if (fastShutdown == -1)
+        return qgetenv("PYSIDE_FAST_SHUTDOWN") == "1";
+    return fastShutdown;
+}
+
+// Leaves the QObjects owned by Python to the operating system, their wrappers must not
+// destroy them when Python deletes the wrappers later. Shiboken has no way to tell the
+// wrappers that the interpreter is finalizing, so each of them is still flagged here.
+static void invalidationVisitor(SbkObject* pyObj, void* data)
+{
+    void** realData = reinterpret_cast<void**>(data);
+    SbkObject* pyQApp = reinterpret_cast<SbkObject*>(realData[0]);
+    PyTypeObject* pyQObjectType = reinterpret_cast<PyTypeObject*>(realData[1]);
+
+    if (pyObj != pyQApp && Shiboken::Object::hasOwnership(pyObj) && PyObject_TypeCheck(pyObj, pyQObjectType))
+        Shiboken::Object::setValidCpp(pyObj, false);
+}
+
 static void destructionVisitor(SbkObject* pyObj, void* data)
 {
     void** realData = reinterpret_cast<void**>(data);
@@ -148,7 +359,7 @@ void destroyQCoreApplication()
     assert(pyQObjectType);
 
     void* data[2] = {pyQApp, pyQObjectType};
-    bm.visitAllPyObjects(&destructionVisitor, &data);
+    bm.visitAllPyObjects(isFastShutdown() ? &invalidationVisitor : &destructionVisitor, &data);
 
     // in the end destroy app
     // Allow threads because the destructor calls
@@ -159,12 +370,6 @@ void destroyQCoreApplication()
     Py_END_ALLOW_THREADS
 }
 
-struct TypeUserData {
-    TypeUserData(PyTypeObject* type, const QMetaObject* metaobject) : mo(type, metaobject) {}
-    DynamicQMetaObject mo;
-    std::size_t cppObjSize;
-};
-
 std::size_t getSizeOfQObject(SbkObjectType* type)
 {
     using namespace Shiboken::ObjectType;
@@ -222,6 +427,54 @@ void initQObjectSubType(SbkObjectType* type, PyObject* args, PyObject* kwds)
     initDynamicMetaObject(type, baseMo, userData->cppObjSize);
 }
 
+// The attributes registered with addLazyAttribute() and not accessed yet
+class LazyAttributes : public QObjectUserData
+{
+public:
+    QHash<QByteArray, QPointer<QObject> > values;
+};
+
+static uint lazyAttributesId()
+{
+    static uint id = QObject::registerUserData();
+    return id;
+}
+
+void addLazyAttribute(QObject* object, const QByteArray& name, QObject* value)
+{
+    LazyAttributes* attributes = static_cast<LazyAttributes*>(object->userData(lazyAttributesId()));
+    if (!attributes) {
+        attributes = new LazyAttributes;
+        object->setUserData(lazyAttributesId(), attributes);
+    }
+    if (!attributes->values.contains(name))
+        attributes->values.insert(name, value);
+}
+
+// Returns the lazy attribute \p name of \p cppSelf wrapped and stored on \p self, or 0
+static PyObject* takeLazyAttribute(QObject* cppSelf, PyObject* self, PyObject* name, const QByteArray& cname)
+{
+    LazyAttributes* attributes = static_cast<LazyAttributes*>(cppSelf->userData(lazyAttributesId()));
+    if (!attributes)
+        return 0;
+    QHash<QByteArray, QPointer<QObject> >::iterator it = attributes->values.find(cname);
+    if (it == attributes->values.end())
+        return 0;
+
+    QObject* value = it.value();
+    attributes->values.erase(it);
+    if (!value)
+        return 0;
+
+    static SbkConverter* converter = Shiboken::Conversions::getConverter("QObject*");
+    PyObject* pyValue = Shiboken::Conversions::pointerToPython(converter, value);
+    if (pyValue && PyObject_SetAttr(self, name, pyValue) < 0) {
+        Py_DECREF(pyValue);
+        return 0;
+    }
+    return pyValue;
+}
+
 PyObject* getMetaDataFromQObject(QObject* cppSelf, PyObject* self, PyObject* name)
 {
     PyObject* attr = PyObject_GenericGetAttr(self, name);
@@ -237,10 +490,11 @@ PyObject* getMetaDataFromQObject(QObject* cppSelf, PyObject* self, PyObject* nam
         attr = value;
     }
 
-    //mutate native signals to signal instance type
+    //mutate native signals to signal instance type, created on each access instead of being
+    //stored on the instance, so objects don't grow with the signals used on them
     if (attr && PyObject_TypeCheck(attr, &PySideSignalType)) {
         PyObject* signal = reinterpret_cast<PyObject*>(Signal::initialize(reinterpret_cast<PySideSignal*>(attr), name, self));
-        PyObject_SetAttr(self, name, reinterpret_cast<PyObject*>(signal));
+        Py_DECREF(attr);
         return signal;
     }
 
@@ -250,29 +504,32 @@ PyObject* getMetaDataFromQObject(QObject* cppSelf, PyObject* self, PyObject* nam
         uint cnameLen = qstrlen(cname);
         if (std::strncmp("__", cname, 2)) {
             const QMetaObject* metaObject = cppSelf->metaObject();
+            QVector<int> methods = MetaMethodIndex::methods(metaObject, QByteArray::fromRawData(cname, cnameLen));
             //signal
             QList<QMetaMethod> signalList;
-            for(int i=0, i_max = metaObject->methodCount(); i < i_max; i++) {
+            foreach (int i, methods) {
                 QMetaMethod method = metaObject->method(i);
-                const char* methSig = method.methodSignature();
-                bool methMacth = !std::strncmp(cname, methSig, cnameLen) && methSig[cnameLen] == '(';
-                if (methMacth) {
-                    if (method.methodType() == QMetaMethod::Signal) {
-                        signalList.append(method);
-                    } else {
-                        PySideMetaFunction* func = MetaFunction::newObject(cppSelf, i);
-                        if (func) {
-                            PyObject_SetAttr(self, name, (PyObject*)func);
-                            return (PyObject*)func;
-                        }
+                if (method.methodType() == QMetaMethod::Signal) {
+                    signalList.append(method);
+                } else {
+                    PySideMetaFunction* func = MetaFunction::newObject(cppSelf, i);
+                    if (func) {
+                        PyObject_SetAttr(self, name, (PyObject*)func);
+                        return (PyObject*)func;
                     }
                 }
             }
             if (signalList.size() > 0) {
                 PyObject* pySignal = reinterpret_cast<PyObject*>(Signal::newObjectFromMethod(self, signalList));
-                PyObject_SetAttr(self, name, pySignal);
+                PyErr_Clear();
                 return pySignal;
             }
+
+            PyObject* lazyAttr = takeLazyAttribute(cppSelf, self, name, QByteArray::fromRawData(cname, cnameLen));
+            if (lazyAttr) {
+                PyErr_Clear();
+                return lazyAttr;
+            }
         }
     }
     return attr;
@@ -300,28 +557,32 @@ void setNextQObjectMemoryAddr(void* addr)
     qobjectNextAddr = addr;
 }
 
-} // namespace PySide
+// Releases the wrapper of a QObject created by C++ when the object is destroyed.
+// Unlike a dynamic property, setting user data doesn't allocate a QVariant nor send an event.
+class WrapperInvalidator : public QObjectUserData
+{
+public:
+    explicit WrapperInvalidator(QObject* object) : m_object(object) {}
 
-// A QSharedPointer is used with a deletion function to invalidate a pointer
-// when the property value is cleared.  This should be a QSharedPointer with
-// a void* pointer, but that isn't allowed
-typedef char any_t;
-Q_DECLARE_METATYPE(QSharedPointer<any_t>);
+    ~WrapperInvalidator()
+    {
+        Shiboken::GilState state;
 
-namespace PySide
-{
+        SbkObject* wrapper = Shiboken::BindingManager::instance().retrieveWrapper(m_object);
+        if (wrapper != NULL)
+            Shiboken::BindingManager::instance().releaseWrapper(wrapper);
+    }
 
-static void invalidatePtr(any_t* object)
-{
-    Shiboken::GilState state;
+private:
+    QObject* m_object;
+};
 
-    SbkObject* wrapper = Shiboken::BindingManager::instance().retrieveWrapper(object);
-    if (wrapper != NULL)
-        Shiboken::BindingManager::instance().releaseWrapper(wrapper);
+static uint wrapperInvalidatorId()
+{
+    static uint id = QObject::registerUserData();
+    return id;
 }
 
-static const char invalidatePropertyName[] = "_PySideInvalidatePtr";
-
 PyObject* getWrapperForQObject(QObject* cppSelf, SbkObjectType* sbk_type)
 {
     PyObject* pyOut = (PyObject*)Shiboken::BindingManager::instance().retrieveWrapper(cppSelf);
@@ -330,19 +591,8 @@ PyObject* getWrapperForQObject(QObject* cppSelf, SbkObjectType* sbk_type)
         return pyOut;
     }
 
-    // Setting the property will trigger an QEvent notification, which may call into
-    // code that creates the wrapper so only set the property if it isn't already
-    // set and check if it's created after the set call
-    QVariant existing = cppSelf->property(invalidatePropertyName);
-    if (!existing.isValid()) {
-        QSharedPointer<any_t> shared_with_del((any_t*)cppSelf, invalidatePtr);
-        cppSelf->setProperty(invalidatePropertyName, QVariant::fromValue(shared_with_del));
-        pyOut = (PyObject*)Shiboken::BindingManager::instance().retrieveWrapper(cppSelf);
-        if (pyOut) {
-            Py_INCREF(pyOut);
-            return pyOut;
-        }
-    }
+    if (!cppSelf->userData(wrapperInvalidatorId()))
+        cppSelf->setUserData(wrapperInvalidatorId(), new WrapperInvalidator(cppSelf));
 
     const char* typeName = typeid(*cppSelf).name();
     pyOut = Shiboken::Object::newObject(sbk_type, cppSelf, false, false, typeName);
@@ -94,9 +94,22 @@ PYSIDE_API void runCleanupFunctions();
 
 /**
  * Destroy a QCoreApplication taking care of destroy all instances of QObject first.
+ * With the fast shutdown enabled the QObjects owned by Python are left to the
+ * operating system instead, see setFastShutdown().
  */
 PYSIDE_API void destroyQCoreApplication();
 
+/**
+ * Enable or disable the fast shutdown: when the interpreter exits, the QObjects owned by Python
+ * are not destroyed one by one before the QCoreApplication, their wrappers are only marked as
+ * invalid and their memory is reclaimed with the process. Their destructors don't run, so it
+ * is only for applications which don't depend on them at exit. Every wrapper is still visited
+ * once and later deallocated by the interpreter, only the C++ destruction is skipped.
+ * It is disabled by default, unless the PYSIDE_FAST_SHUTDOWN environment variable is set to 1.
+ */
+PYSIDE_API void setFastShutdown(bool enabled);
+PYSIDE_API bool isFastShutdown();
+
 /**
  * Check for properties and signals registered on MetaObject and return these
  * \param cppSelf Is the QObject which contains the metaobject
@@ -106,6 +119,16 @@ PYSIDE_API void destroyQCoreApplication();
  */
 PYSIDE_API PyObject* getMetaDataFromQObject(QObject* cppSelf, PyObject* self, PyObject* name);
 
+/**
+ * Make \p value available as the attribute \p name of the wrapper of \p object without wrapping it
+ * now: getMetaDataFromQObject() wraps it and stores the attribute on the first access, unless the
+ * wrapper already resolves \p name to something else. A name registered twice keeps the first value.
+ * \param object The object whose wrapper gets the attribute
+ * \param name The attribute name
+ * \param value The object the attribute refers to, the attribute is dropped if it is deleted first
+ */
+PYSIDE_API void addLazyAttribute(QObject* object, const QByteArray& name, QObject* value);
+
 /**
  * Check if self inherits from class_name
  * \param self Python object
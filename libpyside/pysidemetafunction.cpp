@@ -22,10 +22,12 @@
 #include <sbkpython.h>
 #include "pysidemetafunction.h"
 #include "pysidemetafunction_p.h"
+#include "invocationplan_p.h"
 
 #include <shiboken.h>
 #include <QObject>
 #include <QMetaMethod>
+#include <QVarLengthArray>
 #include <QDebug>
 
 extern "C"
@@ -135,71 +137,37 @@ PySideMetaFunction* newObject(QObject* source, int methodIndex)
     return 0;
 }
 
-bool call(QObject* self, int methodIndex, PyObject* args, PyObject** retVal)
+// Converts the Python sequence to the C++ values expected by \p method, cppArgs[0] is the room for the return value
+static bool prepareCall(const QMetaMethod& method, PyObject* sequence, QVarLengthArray<QVariant, 11>& values,
+                       QVarLengthArray<void*, 11>& cppArgs)
 {
-
-    QMetaMethod method = self->metaObject()->method(methodIndex);
-    QList<QByteArray> argTypes = method.parameterTypes();
+    QSharedPointer<const InvocationPlan> plan = InvocationPlan::get(method);
 
     // args given plus return type
-    Shiboken::AutoDecRef sequence(PySequence_Fast(args, 0));
-    int numArgs = PySequence_Fast_GET_SIZE(sequence.object()) + 1;
+    int numArgs = PySequence_Fast_GET_SIZE(sequence) + 1;
 
-    if (numArgs - 1 != argTypes.count()) {
-        PyErr_Format(PyExc_TypeError, "%s only accepts %d arguments, %d given!", method.methodSignature().constData(), argTypes.count(), numArgs);
+    if (numArgs - 1 != plan->parameterCount()) {
+        PyErr_Format(PyExc_TypeError, "%s only accepts %d arguments, %d given!", method.methodSignature().constData(), plan->parameterCount(), numArgs);
         return false;
     }
 
-    QVariant* methValues = new QVariant[numArgs];
-    void** methArgs = new void*[numArgs];
-
-    // Prepare room for return type
-    const char* returnType = method.typeName();
-    if (returnType && std::strcmp("void", returnType))
-        argTypes.prepend(returnType);
-    else
-        argTypes.prepend(QByteArray());
-
-    int i;
-    for (i = 0; i < numArgs; ++i) {
-        const QByteArray& typeName = argTypes[i];
-        // This must happen only when the method hasn't return type.
-        if (typeName.isEmpty()) {
-            methArgs[i] = 0;
-            continue;
-        }
+    values.resize(numArgs);
+    cppArgs.resize(numArgs);
+    return plan->argumentsToCpp(sequence, values.data(), cppArgs.data());
+}
 
-        Shiboken::Conversions::SpecificConverter converter(typeName);
-        if (converter) {
-            int typeId = QMetaType::type(typeName);
-            if (!Shiboken::Conversions::pythonTypeIsObjectType(converter)) {
-                if (!typeId) {
-                    PyErr_Format(PyExc_TypeError, "Value types used on meta functions (including signals) need to be "
-                                                  "registered on meta type: %s", typeName.data());
-                    break;
-                }
-                methValues[i] = QVariant(typeId, (void*) 0);
-            }
-            methArgs[i] = methValues[i].data();
-            if (i == 0) // Don't do this for return type
-                continue;
-            if (typeId == QVariant::String) {
-                QString tmp;
-                converter.toCpp(PySequence_Fast_GET_ITEM(sequence.object(), i - 1), &tmp);
-                methValues[i] = tmp;
-            } else {
-                converter.toCpp(PySequence_Fast_GET_ITEM(sequence.object(), i - 1), methArgs[i]);
-            }
-        } else {
-            PyErr_Format(PyExc_TypeError, "Unknown type used to call meta function (that may be a signal): %s", argTypes[i].constData());
-            break;
-        }
-    }
+bool call(QObject* self, int methodIndex, PyObject* args, PyObject** retVal)
+{
 
-    bool ok = i == numArgs;
+    QMetaMethod method = self->metaObject()->method(methodIndex);
+    Shiboken::AutoDecRef sequence(PySequence_Fast(args, 0));
+    QVarLengthArray<QVariant, 11> methValues;
+    QVarLengthArray<void*, 11> methArgs;
+
+    bool ok = prepareCall(method, sequence, methValues, methArgs);
     if (ok) {
         Py_BEGIN_ALLOW_THREADS
-        QMetaObject::metacall(self, QMetaObject::InvokeMetaMethod, method.methodIndex(), methArgs);
+        QMetaObject::metacall(self, QMetaObject::InvokeMetaMethod, method.methodIndex(), methArgs.data());
         Py_END_ALLOW_THREADS
 
         if (retVal) {
@@ -215,12 +183,31 @@ bool call(QObject* self, int methodIndex, PyObject* args, PyObject** retVal)
         }
     }
 
-    delete[] methArgs;
-    delete[] methValues;
-
     return ok;
 }
 
+bool activate(QObject* self, int signalIndex, PyObject* args)
+{
+    QMetaMethod method = self->metaObject()->method(signalIndex);
+    Q_ASSERT(method.methodType() == QMetaMethod::Signal);
+    Shiboken::AutoDecRef sequence(PySequence_Fast(args, 0));
+    QVarLengthArray<QVariant, 11> values;
+    QVarLengthArray<void*, 11> cppArgs;
+
+    if (!prepareCall(method, sequence, values, cppArgs))
+        return false;
+
+    EmissionScope scope(cppArgs.data());
+    if (SignalManager::hasPythonReceivers(self, signalIndex)) {
+        // the receivers would take the GIL back right away
+        QMetaObject::activate(self, signalIndex, cppArgs.data());
+    } else {
+        Py_BEGIN_ALLOW_THREADS
+        QMetaObject::activate(self, signalIndex, cppArgs.data());
+        Py_END_ALLOW_THREADS
+    }
+    return true;
+}
 
 } //namespace MetaFunction
 } //namespace PySide
@@ -37,6 +37,12 @@ namespace PySide { namespace MetaFunction {
      */
     bool call(QObject* self, int methodIndex, PyObject* args, PyObject** retVal = 0);
 
+    /**
+     * Emits the signal \p signalIndex of \p self, the arguments are converted with the cached
+     * invocation plan of the signal and delivered straight to QMetaObject::activate.
+     */
+    bool activate(QObject* self, int signalIndex, PyObject* args);
+
 } //namespace MetaFunction
 } //namespace PySide
 
@@ -26,9 +26,17 @@
 #include "dynamicqmetaobject_p.h"
 #include "pysidesignal.h"
 #include "pysidesignal_p.h"
+#include "signalmanager.h"
 
 #include <shiboken.h>
 #include <QDebug>
+#include <QHash>
+#include <QMetaMethod>
+#include <QMetaType>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVariant>
+#include <cstring>
 
 
 #define QPROPERTY_CLASS_NAME "Property"
@@ -104,17 +112,30 @@ PyTypeObject PySidePropertyType = {
     0,                         /*tp_del */
 };
 
+namespace {
+static bool isCurrentValue(PySideProperty* pp, PyObject* self, const void* value);
+}
+
+namespace PySide { namespace Property {
+static int callSetter(PySideProperty* self, PyObject* source, PyObject* value);
+}}
+
 static void qpropertyMetaCall(PySideProperty* pp, PyObject* self, QMetaObject::Call call, void** args)
 {
-    Shiboken::Conversions::SpecificConverter converter(pp->d->typeName);
-    Q_ASSERT(converter);
-
-    QByteArray type(pp->d->typeName);
+    if (pp->d->storage && (call == QMetaObject::ReadProperty || call == QMetaObject::WriteProperty)) {
+        Shiboken::GilState gil;
+        static PyTypeObject* qObjectType = Shiboken::Conversions::getPythonTypeObject("QObject*");
+        QObject* object = reinterpret_cast<QObject*>(Shiboken::Object::cppPointer(reinterpret_cast<SbkObject*>(self), qObjectType));
+        PySide::Property::storageMetaCall(pp, object, call, args, true);
+        return;
+    }
 
     switch(call) {
         case QMetaObject::ReadProperty:
         {
             Shiboken::GilState gil;
+            Shiboken::Conversions::SpecificConverter& converter = PySide::Property::converter(pp);
+            Q_ASSERT(converter);
             PyObject* value = PySide::Property::getValue(pp, self);
             if (value) {
                 converter.toCpp(value, args[0]);
@@ -126,8 +147,12 @@ static void qpropertyMetaCall(PySideProperty* pp, PyObject* self, QMetaObject::C
         case QMetaObject::WriteProperty:
         {
             Shiboken::GilState gil;
+            if (isCurrentValue(pp, self, args[0]))
+                break;
+            Shiboken::Conversions::SpecificConverter& converter = PySide::Property::converter(pp);
+            Q_ASSERT(converter);
             Shiboken::AutoDecRef value(converter.toPython(args[0]));
-            PySide::Property::setValue(pp, self, value);
+            PySide::Property::callSetter(pp, self, value);
             break;
         }
 
@@ -172,24 +197,37 @@ int qpropertyTpInit(PyObject* self, PyObject* args, PyObject* kwds)
 
     static const char *kwlist[] = {"type", "fget", "fset", "freset", "fdel", "doc", "notify",
                                    "designable", "scriptable", "stored", "user",
-                                   "constant", "final", 0};
+                                   "constant", "final", "storage", "detectChanges", 0};
     if (!PyArg_ParseTupleAndKeywords(args, kwds,
-                                     "O|OOOOsObbbbbb:QtCore.QProperty", (char**) kwlist,
+                                     "O|OOOOsObbbbbbbb:QtCore.QProperty", (char**) kwlist,
                                      /*OO*/     &type, &(pData->fget),
                                      /*OOO*/    &(pData->fset), &(pData->freset), &(pData->fdel),
                                      /*s*/      &(pData->doc),
                                      /*O*/      &(pData->notify),
-                                     /*bbbbbb*/ &(pData->designable), &(pData->scriptable), &(pData->stored), &(pData->user), &(pData->constant), &(pData->final))) {
+                                     /*bbbbbb*/ &(pData->designable), &(pData->scriptable), &(pData->stored), &(pData->user), &(pData->constant), &(pData->final),
+                                     /*bb*/     &(pData->storage), &(pData->detectChanges))) {
         return 0;
     }
 
 
     pData->typeName = PySide::Signal::getTypeName(type);
+    if (pData->typeName) {
+        // pointers aren't owned by anybody, the values are kept and compared by copy
+        int typeLength = std::strlen(pData->typeName);
+        if (typeLength && pData->typeName[typeLength - 1] != '*')
+            pData->typeId = QMetaType::type(pData->typeName);
+    }
 
     if (!pData->typeName)
         PyErr_SetString(PyExc_TypeError, "Invalid property type or type name.");
     else if (pData->constant && (pData->fset || pData->notify))
         PyErr_SetString(PyExc_TypeError, "A constant property cannot have a WRITE method or a NOTIFY signal.");
+    else if (pData->storage && (pData->fget || pData->fset || pData->constant))
+        PyErr_SetString(PyExc_TypeError, "A property with storage cannot have READ or WRITE methods or be constant.");
+    else if (pData->storage && !pData->typeId)
+        PyErr_Format(PyExc_TypeError, "The type of a property with storage must be a value type known by QMetaType: %s.", pData->typeName);
+    else if (pData->detectChanges && !pData->notify)
+        PyErr_SetString(PyExc_TypeError, "A property detecting changes needs a NOTIFY signal.");
 
     if (!PyErr_Occurred()) {
         Py_XINCREF(pData->fget);
@@ -296,6 +334,7 @@ static int qpropertyClear(PyObject* self)
     free(data->typeName);
     free(data->doc);
     free(data->notifySignature);
+    delete data->converter;
     delete data;
     reinterpret_cast<PySideProperty*>(self)->d = 0;
     return 0;
@@ -322,6 +361,155 @@ static PyObject* getFromType(PyTypeObject* type, PyObject* name)
     return attr;
 }
 
+// The values of the properties with storage of one object, deleted with it
+struct StoredValue
+{
+    StoredValue() : typeId(0), data(0) {}
+    int typeId;
+    void* data;
+};
+
+class PropertyStorage : public QObjectUserData
+{
+public:
+    ~PropertyStorage()
+    {
+        foreach (const StoredValue& value, values)
+            QMetaType::destroy(value.typeId, value.data);
+    }
+
+    QHash<const PySideProperty*, StoredValue> values;
+};
+
+Q_GLOBAL_STATIC(QMutex, storageMutex)
+
+static uint propertyStorageId()
+{
+    static uint id = QObject::registerUserData();
+    return id;
+}
+
+// Returns the value of \p pp on \p object, a default constructed one at first.
+// Must be called with the storage mutex locked.
+static void* storedValue(QObject* object, const PySideProperty* pp)
+{
+    PropertyStorage* storage = static_cast<PropertyStorage*>(object->userData(propertyStorageId()));
+    if (!storage) {
+        storage = new PropertyStorage;
+        object->setUserData(propertyStorageId(), storage);
+    }
+    StoredValue& value = storage->values[pp];
+    if (!value.data) {
+        value.typeId = pp->d->typeId;
+        value.data = QMetaType::create(value.typeId);
+    }
+    return value.data;
+}
+
+// Copying or creating Python objects needs the GIL
+static bool storageNeedsGil(const PySideProperty* pp)
+{
+    return pp->d->typeId == qMetaTypeId<PySide::PyObjectWrapper>();
+}
+
+// Emits \p signal with \p value, when the signal takes it or no argument at all
+static void notifyStoredValue(QObject* object, const QMetaMethod& signal, int typeId, void* value)
+{
+    int parameterCount = signal.parameterCount();
+    if (parameterCount > 1 || (parameterCount == 1 && signal.parameterType(0) != typeId))
+        return;
+
+    // the local index is the signal one as signals come first, and unlike the overload taking
+    // the absolute index this doesn't call the (maybe Python) metaObject() of the object
+    void* args[] = {0, value};
+    const QMetaObject* metaObject = signal.enclosingMetaObject();
+    QMetaObject::activate(object, metaObject, signal.methodIndex() - metaObject->methodOffset(), args);
+}
+
+// Compares two C++ values of the property type without going through Python.
+// Returns 1 if they are equal, 0 if not and -1 if the type can't be compared natively.
+static int nativeCompare(const PySideProperty* pp, const void* lhs, const void* rhs)
+{
+    int typeId = pp->d->typeId;
+    if (!typeId)
+        return -1;
+    // QVariant knows how to compare the builtin types, others only with registered comparators
+    if (typeId < QMetaType::User)
+        return QVariant(typeId, lhs) == QVariant(typeId, rhs);
+    int result;
+    if (QMetaType::hasRegisteredComparators(typeId) && QMetaType::compare(lhs, rhs, typeId, &result))
+        return result == 0;
+    return -1;
+}
+
+// Compares two Python values of the property, an exception counts as a change.
+// Python builtins (int, float, str...) are compared natively by CPython itself.
+static bool pythonEquals(PyObject* lhs, PyObject* rhs)
+{
+    int result = PyObject_RichCompareBool(lhs, rhs, Py_EQ);
+    if (result < 0)
+        PyErr_Clear();
+    return result > 0;
+}
+
+// Returns false if the property detects changes and \p value is the stored one
+static bool writeStoredValue(QObject* object, const PySideProperty* pp, const void* value)
+{
+    if (pp->d->detectChanges && storageNeedsGil(pp)) {
+        // __eq__ may run any Python code, so the value is compared out of the lock
+        PyObject* current;
+        {
+            QMutexLocker locker(storageMutex());
+            current = *static_cast<PySide::PyObjectWrapper*>(storedValue(object, pp));
+            Py_INCREF(current);
+        }
+        bool equals = pythonEquals(current, *static_cast<const PySide::PyObjectWrapper*>(value));
+        Py_DECREF(current);
+        if (equals)
+            return false;
+    }
+
+    // Destroying the old value may run Python code, which can come back to the storage or
+    // release the GIL, so a copy keeps it alive until the mutex is unlocked
+    void* old;
+    {
+        QMutexLocker locker(storageMutex());
+        void* data = storedValue(object, pp);
+        if (pp->d->detectChanges && nativeCompare(pp, data, value) == 1)
+            return false;
+        old = QMetaType::create(pp->d->typeId, data);
+        QMetaType::destruct(pp->d->typeId, data);
+        QMetaType::construct(pp->d->typeId, data, value);
+    }
+    QMetaType::destroy(pp->d->typeId, old);
+    return true;
+}
+
+// Returns true if the property detects changes and \p value, a C++ value of the property type,
+// is its current value. Reads the current value with the getter, so needs the GIL.
+static bool isCurrentValue(PySideProperty* pp, PyObject* self, const void* value)
+{
+    if (!pp->d->detectChanges || !pp->d->fget)
+        return false;
+
+    Shiboken::AutoDecRef current(PySide::Property::getValue(pp, self));
+    if (current.isNull()) {
+        PyErr_Clear();
+        return false;
+    }
+
+    Shiboken::Conversions::SpecificConverter& converter = PySide::Property::converter(pp);
+    if (pp->d->typeId && Shiboken::Conversions::isPythonToCppConvertible(converter, current)) {
+        QVariant currentValue(pp->d->typeId, (void*) 0);
+        converter.toCpp(current, currentValue.data());
+        int result = nativeCompare(pp, currentValue.constData(), value);
+        if (result != -1)
+            return result;
+    }
+    Shiboken::AutoDecRef newValue(converter.toPython(value));
+    return pythonEquals(current, newValue);
+}
+
 } //namespace
 
 
@@ -349,7 +537,52 @@ bool isPropertyType(PyObject* pyObj)
     return checkType(pyObj);
 }
 
-int setValue(PySideProperty* self, PyObject* source, PyObject* value)
+static QObject* storageOwner(PyObject* source)
+{
+    static PyTypeObject* qObjectType = Shiboken::Conversions::getPythonTypeObject("QObject*");
+    if (!PyObject_TypeCheck(source, qObjectType)) {
+        PyErr_SetString(PyExc_TypeError, "Properties with storage can only be used on QObjects.");
+        return 0;
+    }
+    return reinterpret_cast<QObject*>(Shiboken::Object::cppPointer(reinterpret_cast<SbkObject*>(source), qObjectType));
+}
+
+static int setStoredValue(PySideProperty* self, PyObject* source, PyObject* value)
+{
+    QObject* object = storageOwner(source);
+    if (!object)
+        return -1;
+
+    Shiboken::Conversions::SpecificConverter& converter = PySide::Property::converter(self);
+    if (!Shiboken::Conversions::isPythonToCppConvertible(converter, value)) {
+        PyErr_Format(PyExc_TypeError, "Invalid value for a property of type %s.", self->d->typeName);
+        return -1;
+    }
+    int typeId = self->d->typeId;
+    void* cppValue = QMetaType::create(typeId);
+    converter.toCpp(value, cppValue);
+    if (writeStoredValue(object, self, cppValue) && self->d->notify) {
+        const QMetaObject* metaObject = object->metaObject();
+        int index = metaObject->indexOfSignal(getNotifyName(self));
+        if (index != -1)
+            notifyStoredValue(object, metaObject->method(index), typeId, cppValue);
+    }
+    QMetaType::destroy(typeId, cppValue);
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+static PyObject* getStoredValue(PySideProperty* self, PyObject* source)
+{
+    QObject* object = storageOwner(source);
+    if (!object)
+        return 0;
+
+    Shiboken::Conversions::SpecificConverter& converter = PySide::Property::converter(self);
+    QMutexLocker locker(storageMutex());
+    return converter.toPython(storedValue(object, self));
+}
+
+static int callSetter(PySideProperty* self, PyObject* source, PyObject* value)
 {
     PyObject* fset = self->d->fset;
     if (fset) {
@@ -366,8 +599,26 @@ int setValue(PySideProperty* self, PyObject* source, PyObject* value)
     return -1;
 }
 
+int setValue(PySideProperty* self, PyObject* source, PyObject* value)
+{
+    if (self->d->storage)
+        return setStoredValue(self, source, value);
+
+    if (self->d->detectChanges && self->d->fget && self->d->fset) {
+        Shiboken::AutoDecRef current(getValue(self, source));
+        if (current.isNull())
+            return -1;
+        if (pythonEquals(current, value))
+            return 0;
+    }
+    return callSetter(self, source, value);
+}
+
 PyObject* getValue(PySideProperty* self, PyObject* source)
 {
+    if (self->d->storage)
+        return getStoredValue(self, source);
+
     PyObject* fget = self->d->fget;
     if (fget) {
         Shiboken::AutoDecRef args(PyTuple_New(1));
@@ -425,7 +676,7 @@ bool isReadable(const PySideProperty* self)
 
 bool isWritable(const PySideProperty* self)
 {
-    return (self->d->fset != 0);
+    return (self->d->fset != 0 || self->d->storage);
 }
 
 bool hasReset(const PySideProperty* self)
@@ -474,6 +725,50 @@ const char* getNotifyName(PySideProperty* self)
     return self->d->notifySignature;
 }
 
+Shiboken::Conversions::SpecificConverter& converter(PySideProperty* self)
+{
+    if (!self->d->converter)
+        self->d->converter = new Shiboken::Conversions::SpecificConverter(self->d->typeName);
+    return *self->d->converter;
+}
+
+bool hasStorage(const PySideProperty* self)
+{
+    return self->d->storage;
+}
+
+bool storageMetaCall(PySideProperty* self, QObject* object, QMetaObject::Call call, void** args, bool holdsGil)
+{
+    if (!holdsGil && storageNeedsGil(self))
+        return false;
+
+    int typeId = self->d->typeId;
+    if (call == QMetaObject::ReadProperty) {
+        // the value in args[0] is replaced out of the lock, for the same reason as in writeStoredValue()
+        void* value;
+        {
+            QMutexLocker locker(storageMutex());
+            value = QMetaType::create(typeId, storedValue(object, self));
+        }
+        QMetaType::destruct(typeId, args[0]);
+        QMetaType::construct(typeId, args[0], value);
+        QMetaType::destroy(typeId, value);
+        return true;
+    }
+
+    if (!writeStoredValue(object, self, args[0]))
+        return true;
+    // the notify signature is computed with the GIL when the property is added to the metaobject
+    const char* notifyName = holdsGil && self->d->notify ? getNotifyName(self) : self->d->notifySignature;
+    if (notifyName) {
+        const QMetaObject* metaObject = object->metaObject();
+        int index = metaObject->indexOfSignal(notifyName);
+        if (index != -1)
+            notifyStoredValue(object, metaObject->method(index), typeId, args[0]);
+    }
+    return true;
+}
+
 void setMetaCallHandler(PySideProperty* self, MetaCallHandler handler)
 {
     self->d->metaCallHandler = handler;
@@ -24,7 +24,9 @@
 #define PYSIDE_QPROPERTY_P_H
 
 #include <sbkpython.h>
+#include <sbkconverter.h>
 #include <QMetaObject>
+#include <QObject>
 #include "pysideproperty.h"
 
 struct PySideProperty;
@@ -49,6 +51,10 @@ struct PySidePropertyPrivate {
     bool constant;
     bool final;
     void* userData;
+    bool storage;       // values are kept by PySide, see Property(..., storage=True)
+    bool detectChanges; // writes of the current value are dropped, see Property(..., detectChanges=True)
+    int typeId;         // QMetaType of the value, 0 for pointers and unregistered types
+    Shiboken::Conversions::SpecificConverter* converter; // created on first use, see converter()
 };
 
 } // extern "C"
@@ -161,6 +167,37 @@ bool isConstant(const PySideProperty* self);
  **/
 bool isFinal(const PySideProperty* self);
 
+/**
+ * Return the converter for the type of the property, resolved on the first call.
+ * Requires the GIL.
+ *
+ * @param   self The property object
+ * @return  Return the converter, which belongs to the property
+ **/
+Shiboken::Conversions::SpecificConverter& converter(PySideProperty* self);
+
+/**
+ * This function check if the property values are kept by PySide instead of read and written
+ * by Python functions, see Property(type, storage=True)
+ * This function does not check the property object type
+ *
+ * @param   self The property object
+ * @return  Return a boolean value
+ **/
+bool hasStorage(const PySideProperty* self);
+
+/**
+ * Read or write the value kept for a property with storage on \p object, as requested by a
+ * QMetaObject::ReadProperty or QMetaObject::WriteProperty meta call. Writes emit the notify
+ * signal of the property. Only the values of Python types need the GIL.
+ *
+ * @param   self The property object
+ * @param   object The QObject which has the property
+ * @param   holdsGil Whether the caller holds the GIL
+ * @return  Return false if the call needs the GIL and the caller doesn't hold it
+ **/
+bool storageMetaCall(PySideProperty* self, QObject* object, QMetaObject::Call call, void** args, bool holdsGil);
+
 } // namespace Property
 } // namespace PySide
 
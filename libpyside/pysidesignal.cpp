@@ -24,6 +24,8 @@
 #include "pysidesignal.h"
 #include "pysidesignal_p.h"
 #include "signalmanager.h"
+#include "pysidemetafunction_p.h"
+#include "metamethodindex_p.h"
 
 #include <shiboken.h>
 #include <QDebug>
@@ -50,6 +52,8 @@ extern "C"
 static int signalTpInit(PyObject*, PyObject*, PyObject*);
 static void signalFree(void*);
 static void signalInstanceFree(void*);
+static int signalInstanceTraverse(PyObject* self, visitproc visit, void* arg);
+static int signalInstanceClear(PyObject* self);
 static PyObject* signalGetItem(PyObject* self, PyObject* key);
 static PyObject* signalToString(PyObject* self);
 
@@ -191,10 +195,10 @@ PyTypeObject PySideSignalInstanceType = {
     /*tp_getattro*/         0,
     /*tp_setattro*/         0,
     /*tp_as_buffer*/        0,
-    /*tp_flags*/            Py_TPFLAGS_DEFAULT,
+    /*tp_flags*/            Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
     /*tp_doc*/              SIGNAL_INSTANCE_NAME,
-    /*tp_traverse*/         0,
-    /*tp_clear*/            0,
+    /*tp_traverse*/         signalInstanceTraverse,
+    /*tp_clear*/            signalInstanceClear,
     /*tp_richcompare*/      0,
     /*tp_weaklistoffset*/   0,
     /*tp_iter*/             0,
@@ -303,32 +307,93 @@ void signalInstanceFree(void* self)
     PyObject* pySelf = reinterpret_cast<PyObject*>(self);
     PySideSignalInstance* data = reinterpret_cast<PySideSignalInstance*>(self);
 
+    PyObject_GC_UnTrack(pySelf);
     PySideSignalInstancePrivate* dataPvt = data->d;
-    free(dataPvt->signalName);
-    free(dataPvt->signature);
+    PyObject* source = 0;
+    if (dataPvt) {
+        free(dataPvt->signalName);
+        free(dataPvt->signature);
+
+        Py_XDECREF(dataPvt->homonymousMethod);
+        Py_XDECREF(dataPvt->next);
+        source = dataPvt->source;
+        delete dataPvt;
+        data->d = 0;
+    }
+    PyObject_GC_Del(self);
+    Py_XDECREF(source);
+}
 
-    Py_XDECREF(dataPvt->homonymousMethod);
+// A signal instance stored on its source, e.g. with self.x = self.sig, makes a reference cycle
+int signalInstanceTraverse(PyObject* self, visitproc visit, void* arg)
+{
+    PySideSignalInstancePrivate* dataPvt = reinterpret_cast<PySideSignalInstance*>(self)->d;
+    if (dataPvt) {
+        Py_VISIT(dataPvt->source);
+        Py_VISIT(dataPvt->homonymousMethod);
+        Py_VISIT(reinterpret_cast<PyObject*>(dataPvt->next));
+    }
+    return 0;
+}
 
-    if (dataPvt->next) {
-        Py_DECREF(dataPvt->next);
-        dataPvt->next = 0;
+// The source is replaced by None, so a cleared instance raises errors instead of crashing if used
+int signalInstanceClear(PyObject* self)
+{
+    PySideSignalInstancePrivate* dataPvt = reinterpret_cast<PySideSignalInstance*>(self)->d;
+    if (dataPvt) {
+        PyObject* source = dataPvt->source;
+        Py_INCREF(Py_None);
+        dataPvt->source = Py_None;
+        Py_XDECREF(source);
+        Py_CLEAR(dataPvt->homonymousMethod);
+        Py_CLEAR(dataPvt->next);
     }
-    delete dataPvt;
-    data->d = 0;
-    pySelf->ob_type->tp_base->tp_free(self);
+    return 0;
+}
+
+static PyObject* connectCoalesced(PySideSignalInstance* source, PyObject* slot, int interval)
+{
+    static PyTypeObject* qObjectType = Shiboken::Conversions::getPythonTypeObject("QObject*");
+    if (slot->ob_type == &PySideSignalInstanceType || !PyCallable_Check(slot)) {
+        PyErr_SetString(PyExc_TypeError, "Coalesced connections need a Python callable as slot.");
+        return 0;
+    }
+    if (!qObjectType || !PyObject_TypeCheck(source->d->source, qObjectType)) {
+        PyErr_Format(PyExc_TypeError, "Failed to connect signal %s.", source->d->signature);
+        return 0;
+    }
+    SbkObject* sbkSource = reinterpret_cast<SbkObject*>(source->d->source);
+    if (!Shiboken::Object::isValid(sbkSource))
+        return 0;
+
+    QObject* cppSource = reinterpret_cast<QObject*>(Shiboken::Object::cppPointer(sbkSource, qObjectType));
+    if (PySide::SignalManager::instance().connectCoalesced(cppSource, source->d->signature, slot, interval))
+        Py_RETURN_TRUE;
+
+    if (!PyErr_Occurred())
+        PyErr_Format(PyExc_RuntimeError, "Failed to connect signal %s.", source->d->signature);
+    return 0;
 }
 
 PyObject* signalInstanceConnect(PyObject* self, PyObject* args, PyObject* kwds)
 {
     PyObject* slot = 0;
     PyObject* type = 0;
-    static const char* kwlist[] = {"slot", "type", 0};
+    int interval = -1;
+    static const char* kwlist[] = {"slot", "type", "interval", 0};
 
     if (!PyArg_ParseTupleAndKeywords(args, kwds,
-        "O|O:" SIGNAL_INSTANCE_NAME, const_cast<char**>(kwlist), &slot, &type))
+        "O|Oi:" SIGNAL_INSTANCE_NAME, const_cast<char**>(kwlist), &slot, &type, &interval))
         return 0;
 
     PySideSignalInstance* source = reinterpret_cast<PySideSignalInstance*>(self);
+
+    if (type && PyInt_Check(type) && PyInt_AsLong(type) == PySide::CoalescedConnection)
+        return connectCoalesced(source, slot, qMax(interval, 0));
+    if (interval != -1) {
+        PyErr_SetString(PyExc_TypeError, "interval is only accepted by coalesced connections.");
+        return 0;
+    }
     Shiboken::AutoDecRef pyArgs(PyList_New(0));
 
     bool match = false;
@@ -382,10 +447,40 @@ PyObject* signalInstanceConnect(PyObject* self, PyObject* args, PyObject* kwds)
     return 0;
 }
 
+// Signal instances are created on each access, so the index of the signal is found through
+// the method names instead of comparing the signature with every method
+static int indexOfSignal(const QMetaObject* metaObject, const PySideSignalInstancePrivate* signal)
+{
+    QVector<int> methods = PySide::MetaMethodIndex::methods(metaObject, QByteArray::fromRawData(signal->signalName, std::strlen(signal->signalName)));
+    foreach (int index, methods) {
+        QMetaMethod method = metaObject->method(index);
+        if (method.methodType() == QMetaMethod::Signal && !std::strcmp(method.methodSignature(), signal->signature))
+            return index;
+    }
+    return metaObject->indexOfSignal(signal->signature);
+}
+
 PyObject* signalInstanceEmit(PyObject* self, PyObject* args)
 {
     PySideSignalInstance* source = reinterpret_cast<PySideSignalInstance*>(self);
 
+    // Fast path: emit straight through the metaobject using the cached signal index
+    static PyTypeObject* qObjectType = Shiboken::Conversions::getPythonTypeObject("QObject*");
+    SbkObject* sbkSource = reinterpret_cast<SbkObject*>(source->d->source);
+    if (qObjectType && PyObject_TypeCheck(source->d->source, qObjectType)) {
+        if (!Shiboken::Object::isValid(sbkSource))
+            return 0;
+        QObject* cppSource = reinterpret_cast<QObject*>(Shiboken::Object::cppPointer(sbkSource, qObjectType));
+        const QMetaObject* metaObject = cppSource->metaObject();
+        if (source->d->signalIndex == -1)
+            source->d->signalIndex = indexOfSignal(metaObject, source->d);
+        if (source->d->signalIndex != -1 && source->d->signalIndex < metaObject->methodCount()) {
+            if (!PySide::MetaFunction::activate(cppSource, source->d->signalIndex, args))
+                return 0;
+            Py_RETURN_TRUE;
+        }
+    }
+
     Shiboken::AutoDecRef pyArgs(PyList_New(0));
     Shiboken::AutoDecRef sourceSignature(PySide::Signal::buildQtCompatible(source->d->signature));
 
@@ -533,6 +628,8 @@ void init(PyObject* module)
         return;
 
     Py_INCREF(&PySideSignalInstanceType);
+
+    PyModule_AddIntConstant(module, "CoalescedConnection", PySide::CoalescedConnection);
 }
 
 bool checkType(PyObject* pyObj)
@@ -542,25 +639,6 @@ bool checkType(PyObject* pyObj)
     return false;
 }
 
-void updateSourceObject(PyObject* source)
-{
-    PyTypeObject* objType = reinterpret_cast<PyTypeObject*>(PyObject_Type(source));
-
-    Py_ssize_t pos = 0;
-    PyObject* value;
-    PyObject* key;
-
-    while (PyDict_Next(objType->tp_dict, &pos, &key, &value)) {
-        if (PyObject_TypeCheck(value, &PySideSignalType)) {
-            Shiboken::AutoDecRef signalInstance((PyObject*)PyObject_New(PySideSignalInstance, &PySideSignalInstanceType));
-            instanceInitialize(signalInstance.cast<PySideSignalInstance*>(), key, reinterpret_cast<PySideSignal*>(value), source, 0);
-            PyObject_SetAttr(source, key, signalInstance);
-        }
-    }
-
-    Py_XDECREF(objType);
-}
-
 char* getTypeName(PyObject* type)
 {
     if (PyType_Check(type)) {
@@ -641,7 +719,7 @@ void appendSignature(PySideSignal* self, char* signature)
 
 PySideSignalInstance* initialize(PySideSignal* self, PyObject* name, PyObject* object)
 {
-    PySideSignalInstance* instance = PyObject_New(PySideSignalInstance, &PySideSignalInstanceType);
+    PySideSignalInstance* instance = PyObject_GC_New(PySideSignalInstance, &PySideSignalInstanceType);
     instanceInitialize(instance, name, self, object, 0);
     return instance;
 }
@@ -659,7 +737,9 @@ void instanceInitialize(PySideSignalInstance* self, PyObject* name, PySideSignal
     }
 
     selfPvt->source = source;
+    Py_INCREF(source);
     selfPvt->signature = buildSignature(self->d->signalName, data->signatures[index]);
+    selfPvt->signalIndex = -1;
     selfPvt->homonymousMethod = 0;
     if (data->homonymousMethod) {
         selfPvt->homonymousMethod = data->homonymousMethod;
@@ -668,9 +748,10 @@ void instanceInitialize(PySideSignalInstance* self, PyObject* name, PySideSignal
     index++;
 
     if (index < data->signaturesSize) {
-        selfPvt->next = PyObject_New(PySideSignalInstance, &PySideSignalInstanceType);
+        selfPvt->next = PyObject_GC_New(PySideSignalInstance, &PySideSignalInstanceType);
         instanceInitialize(selfPvt->next, name, data, source, index);
     }
+    PyObject_GC_Track(self);
 }
 
 bool connect(PyObject* source, const char* signal, PyObject* callback)
@@ -695,7 +776,7 @@ PySideSignalInstance* newObjectFromMethod(PyObject* source, const QList<QMetaMet
     PySideSignalInstance* root = 0;
     PySideSignalInstance* previous = 0;
     foreach(QMetaMethod m, methodList) {
-        PySideSignalInstance* item = PyObject_New(PySideSignalInstance, &PySideSignalInstanceType);
+        PySideSignalInstance* item = PyObject_GC_New(PySideSignalInstance, &PySideSignalInstanceType);
         if (!root)
             root = item;
 
@@ -705,13 +786,16 @@ PySideSignalInstance* newObjectFromMethod(PyObject* source, const QList<QMetaMet
         item->d = new PySideSignalInstancePrivate;
         PySideSignalInstancePrivate* selfPvt = item->d;
         selfPvt->source = source;
+        Py_INCREF(source);
         QByteArray cppName(m.methodSignature());
         cppName = cppName.mid(0, cppName.indexOf('('));
         // separe SignalName
         selfPvt->signalName = strdup(cppName.data());
         selfPvt->signature = strdup(m.methodSignature());
+        selfPvt->signalIndex = m.methodIndex();
         selfPvt->homonymousMethod = 0;
         selfPvt->next = 0;
+        PyObject_GC_Track(item);
     }
     return root;
 }
@@ -102,14 +102,6 @@ PYSIDE_API PyObject* getObject(PySideSignalInstance* signal);
  **/
 PYSIDE_API const char* getSignature(PySideSignalInstance* signal);
 
-/**
- * This function is used to retrieve the signal signature
- *
- * @param   self The Signal object
- * @return  Return the signal signature
- **/
-PYSIDE_API void updateSourceObject(PyObject* source);
-
 /**
  * @deprecated Use registerSignals
  **/
@@ -45,6 +45,7 @@ extern "C"
         PyObject* source;
         PyObject* homonymousMethod;
         PySideSignalInstance* next;
+        int signalIndex; // resolved on the first emission, -1 while unknown
     };
 
 
@@ -53,6 +53,10 @@ private:
 PYSIDE_API QDataStream &operator<<(QDataStream& out, const PyObjectWrapper& myObj);
 PYSIDE_API QDataStream &operator>>(QDataStream& in, PyObjectWrapper& myObj);
 
+/// Connection type accepted by SignalInstance.connect() for connections which only deliver the
+/// arguments of the last emission, at most once per event loop iteration or interval
+const int CoalescedConnection = 0x100;
+
 class PYSIDE_API SignalManager
 {
 public:
@@ -63,6 +67,10 @@ public:
     int globalReceiverSlotIndex(QObject* sender, const char* slotSignature) const;
     void notifyGlobalReceiver(QObject* receiver);
 
+    // Coalesced connections of signals to Python callbacks, see CoalescedConnection
+    bool connectCoalesced(QObject* source, const char* signal, PyObject* callback, int interval);
+    bool disconnectCoalesced(QObject* source, int signalIndex, PyObject* callback);
+
     bool emitSignal(QObject* source, const char* signal, PyObject* args);
     static int qt_metacall(QObject* object, QMetaObject::Call call, int id, void** args);
 
@@ -79,6 +87,12 @@ public:
     // Disconnect all signals managed by Globalreceiver
     void clear();
 
+    // Bookkeeping of the connections made from Python to Python code, signals without them
+    // are emitted with the GIL released
+    static void addPythonReceiver(QObject* sender, int signalIndex);
+    static void removePythonReceiver(QObject* sender, int signalIndex);
+    static bool hasPythonReceivers(const QObject* sender, int signalIndex);
+
     // Utility function to call a python method usign args received in qt_metacall
     static int callPythonMetaMethod(const QMetaMethod& method, void** args, PyObject* obj, bool isShortCuit);
 
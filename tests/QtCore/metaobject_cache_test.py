@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+
+'''Test cases for the on disk cache of the metaobjects of Python classes'''
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import unittest
+
+SCRIPT = '''
+from PySide2.QtCore import QObject, Signal, Slot, Property, ClassInfo
+
+@ClassInfo(Author='PySide')
+class CachedObject(QObject):
+    valueChanged = Signal(int)
+    named = Signal(str, int)
+
+    def __init__(self):
+        QObject.__init__(self)
+        self._value = 0
+
+    @Slot(int, result=int)
+    def double(self, value):
+        return value * 2
+
+    def getValue(self):
+        return self._value
+
+    def setValue(self, value):
+        self._value = value
+        self.valueChanged.emit(value)
+
+    value = Property(int, getValue, setValue, notify=valueChanged)
+
+mo = CachedObject.staticMetaObject
+lines = [mo.className(), mo.classInfo(mo.classInfoOffset()).value()]
+lines += [bytes(mo.method(i).methodSignature()).decode() for i in range(mo.methodCount())]
+lines += ['%s %s' % (mo.property(i).name(), mo.property(i).typeName()) for i in range(mo.propertyCount())]
+obj = CachedObject()
+obj.value = 3
+lines.append(str(obj.property('value')))
+print('|'.join(lines))
+'''
+
+
+class MetaObjectCacheTest(unittest.TestCase):
+
+    def setUp(self):
+        self.cacheDir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.cacheDir)
+
+    def run_script(self, cacheDir):
+        env = dict(os.environ)
+        env['PYSIDE_METAOBJECT_CACHE'] = cacheDir
+        output = subprocess.check_output([sys.executable, '-c', SCRIPT], env=env)
+        return output.strip()
+
+    def testCacheHit(self):
+        uncached = self.run_script('0')
+        self.assertEqual(os.listdir(self.cacheDir), [])
+
+        first = self.run_script(self.cacheDir)
+        entries = os.listdir(self.cacheDir)
+        self.assertTrue([e for e in entries if e.startswith('__main__.CachedObject-')])
+
+        second = self.run_script(self.cacheDir)
+        self.assertEqual(sorted(os.listdir(self.cacheDir)), sorted(entries))
+        self.assertEqual(first, uncached)
+        self.assertEqual(second, uncached)
+
+    def testCorruptedEntry(self):
+        expected = self.run_script(self.cacheDir)
+        for entry in os.listdir(self.cacheDir):
+            with open(os.path.join(self.cacheDir, entry), 'wb') as f:
+                f.write(b'garbage')
+        self.assertEqual(self.run_script(self.cacheDir), expected)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+
+'''Test cases for properties and signals given as keyword arguments to QObject constructors'''
+
+import gc
+import unittest
+import weakref
+
+from PySide2.QtCore import QObject, QTimer, Property
+
+
+class NamedObject(QObject):
+    def __init__(self, **kwargs):
+        self.names = []
+        QObject.__init__(self, **kwargs)
+
+    def setObjectName(self, name):
+        self.names.append(name)
+        QObject.setObjectName(self, name)
+
+
+class ValueObject(QObject):
+    def __init__(self, **kwargs):
+        self._value = 0
+        QObject.__init__(self, **kwargs)
+
+    def getValue(self):
+        return self._value
+
+    def setValue(self, value):
+        self._value = value
+
+    value = Property(int, getValue, setValue)
+
+
+class GetattrSetterObject(QObject):
+    def getValue(self):
+        return self._value
+
+    value = Property(int, getValue)
+
+    def __getattr__(self, name):
+        if name == 'setValue':
+            return self.doubleValue
+        raise AttributeError(name)
+
+    def doubleValue(self, value):
+        self._value = value * 2
+
+
+class CtorKwargsTest(unittest.TestCase):
+
+    def testRepeatedConstruction(self):
+        for i in range(3):
+            timer = QTimer(interval=i + 10, singleShot=True)
+            self.assertEqual(timer.interval(), i + 10)
+            self.assertTrue(timer.isSingleShot())
+
+    def testOverriddenSetter(self):
+        for name in ('a', 'b'):
+            obj = NamedObject(objectName=name)
+            self.assertEqual(obj.names, [name])
+            self.assertEqual(obj.objectName(), name)
+
+    def testReplacedSetter(self):
+        calls = []
+        NamedObject(objectName='a')
+        original = NamedObject.setObjectName
+        NamedObject.setObjectName = lambda self, name: calls.append(name)
+        try:
+            NamedObject(objectName='b')
+        finally:
+            NamedObject.setObjectName = original
+        self.assertEqual(calls, ['b'])
+
+    def testPythonProperty(self):
+        for i in range(3):
+            self.assertEqual(ValueObject(value=i).value, i)
+
+    def testSetterFromGetattr(self):
+        for i in range(3):
+            self.assertEqual(GetattrSetterObject(value=i).value, i * 2)
+
+    def testDynamicClassSetterReleased(self):
+        class Dynamic(QObject):
+            def setObjectName(self, name):
+                QObject.setObjectName(self, name)
+        Dynamic(objectName='a')
+        ref = weakref.ref(Dynamic.__dict__['setObjectName'])
+        del Dynamic
+        gc.collect()
+        self.assertEqual(ref(), None)
+
+    def testSignal(self):
+        received = []
+        for i in range(2):
+            obj = QObject(destroyed=lambda: received.append(i))
+            del obj
+        self.assertEqual(len(received), 2)
+
+    def testInvalidKeyword(self):
+        for i in range(2):
+            self.assertRaises(AttributeError, QObject, invalidKeyword=1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,31 @@
+#!/usr/bin/env python
+
+'''Test cases for attributes resolved through the metaobject of QObjects'''
+
+import unittest
+
+from PySide2.QtCore import QObject, QTimer, SIGNAL
+
+
+class MetaMethodLookupTest(unittest.TestCase):
+
+    def testMissingAttribute(self):
+        timer = QTimer()
+        for i in range(3):
+            self.assertRaises(AttributeError, getattr, timer, 'missingMethod')
+        self.assertFalse(hasattr(timer, 'time'))
+
+    def testDynamicSignal(self):
+        obj = QObject()
+        self.assertFalse(hasattr(obj, 'dynamicSignal'))
+        obj.emit(SIGNAL('dynamicSignal(int)'), 1)
+        self.assertTrue(hasattr(obj, 'dynamicSignal'))
+
+        received = []
+        obj.dynamicSignal.connect(received.append)
+        obj.emit(SIGNAL('dynamicSignal(int)'), 2)
+        self.assertEqual(received, [2])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -115,6 +115,37 @@ class ParentCase(unittest.TestCase):
         res = parent.findChildren(QObject, QRegExp("^fo+"))
         self.assertEqual(res, test_children)
 
+    def testFindChildrenPythonType(self):
+        class PyTimer(QTimer):
+            pass
+
+        parent = QObject()
+        timer = QTimer(parent)
+        pyTimers = [PyTimer(timer), PyTimer(parent)]
+        QObject(parent)
+
+        self.assertEqual(parent.findChildren(PyTimer), pyTimers)
+        self.assertEqual(parent.findChildren(QTimer), [timer] + pyTimers)
+        self.assertEqual(parent.findChild(PyTimer), pyTimers[1])
+
+    def testFindChildrenIter(self):
+        parent = QObject()
+        children = [QTimer(parent) for i in range(5)]
+        children.extend([QObject(parent) for i in range(5)])
+        grandChild = QTimer(children[-1])
+        for i, child in enumerate(children):
+            child.setObjectName('foo' if i % 2 else 'bar')
+
+        self.assertEqual(list(parent.findChildrenIter(QObject)), parent.findChildren(QObject))
+        self.assertEqual(list(parent.findChildrenIter(QTimer)), children[:5] + [grandChild])
+        self.assertEqual(list(parent.findChildrenIter(QTimer, 'foo')), parent.findChildren(QTimer, 'foo'))
+        self.assertEqual(list(parent.findChildrenIter(QObject, QRegExp('^ba'))),
+                         parent.findChildren(QObject, QRegExp('^ba')))
+
+        it = parent.findChildrenIter(QTimer)
+        self.assertEqual(next(it), children[0])
+        self.assertEqual(len(list(it)), 5)
+
 
     def testParentEquality(self):
         #QObject.parent() == parent
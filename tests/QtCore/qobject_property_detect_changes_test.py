@@ -0,0 +1,72 @@
+#!/usr/bin/env python
+
+'''Test cases for properties which only notify changes of their value'''
+
+import unittest
+
+from PySide2.QtCore import QObject, Property, Signal
+
+
+class ChangesObject(QObject):
+    valueChanged = Signal(int)
+    textChanged = Signal(str)
+    dataChanged = Signal()
+
+    def __init__(self):
+        QObject.__init__(self)
+        self._value = 0
+        self.setterCalls = 0
+
+    def getValue(self):
+        return self._value
+
+    def setValue(self, value):
+        self.setterCalls += 1
+        self._value = value
+        self.valueChanged.emit(value)
+
+    value = Property(int, getValue, setValue, notify=valueChanged, detectChanges=True)
+    text = Property(str, notify=textChanged, storage=True, detectChanges=True)
+    data = Property(object, notify=dataChanged, storage=True, detectChanges=True)
+
+
+class PropertyDetectChangesTest(unittest.TestCase):
+
+    def testSetter(self):
+        obj = ChangesObject()
+        values = []
+        obj.valueChanged.connect(values.append)
+        obj.value = 1
+        obj.value = 1
+        obj.setProperty('value', 1)
+        obj.setProperty('value', 2)
+        obj.value = 2
+        self.assertEqual(values, [1, 2])
+        self.assertEqual(obj.setterCalls, 2)
+
+    def testStorage(self):
+        obj = ChangesObject()
+        texts = []
+        obj.textChanged.connect(texts.append)
+        obj.text = 'a'
+        obj.text = 'a'
+        obj.setProperty('text', 'a')
+        obj.setProperty('text', 'b')
+        self.assertEqual(texts, ['a', 'b'])
+        self.assertEqual(obj.text, 'b')
+
+    def testPythonValue(self):
+        obj = ChangesObject()
+        changes = []
+        obj.dataChanged.connect(lambda: changes.append(obj.data))
+        obj.data = [1]
+        obj.data = [1]
+        obj.data = (1,)
+        self.assertEqual(changes, [[1], (1,)])
+
+    def testNeedsNotify(self):
+        self.assertRaises(TypeError, Property, int, storage=True, detectChanges=True)
+
+
+if __name__ == '__main__':
+    unittest.main()
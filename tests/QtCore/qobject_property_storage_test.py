@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+
+'''Test cases for properties whose values are kept by PySide'''
+
+import unittest
+
+from PySide2.QtCore import QObject, Property, Signal
+
+
+class StorageObject(QObject):
+    countChanged = Signal(int)
+    nameChanged = Signal()
+
+    count = Property(int, notify=countChanged, storage=True)
+    name = Property(str, notify=nameChanged, storage=True)
+    data = Property(object, storage=True)
+
+
+class PropertyStorageTest(unittest.TestCase):
+
+    def testDefaultValues(self):
+        obj = StorageObject()
+        self.assertEqual(obj.count, 0)
+        self.assertEqual(obj.name, '')
+        self.assertEqual(obj.property('count'), 0)
+
+    def testPythonAccess(self):
+        obj = StorageObject()
+        obj.count = 42
+        obj.name = 'pyside'
+        self.assertEqual(obj.count, 42)
+        self.assertEqual(obj.name, 'pyside')
+        self.assertEqual(StorageObject().count, 0)
+
+    def testMetaObjectAccess(self):
+        obj = StorageObject()
+        self.assertTrue(obj.setProperty('count', 7))
+        self.assertEqual(obj.count, 7)
+        obj.count = 8
+        self.assertEqual(obj.property('count'), 8)
+
+    def testPythonObjectValue(self):
+        obj = StorageObject()
+        value = [1, 2]
+        obj.data = value
+        self.assertTrue(obj.data is value)
+        self.assertTrue(obj.property('data') is value)
+
+    def testNotify(self):
+        obj = StorageObject()
+        counts = []
+        names = []
+        obj.countChanged.connect(counts.append)
+        obj.nameChanged.connect(lambda: names.append(obj.name))
+        obj.count = 1
+        obj.setProperty('count', 2)
+        obj.name = 'a'
+        self.assertEqual(counts, [1, 2])
+        self.assertEqual(names, ['a'])
+
+    def testInvalidValue(self):
+        obj = StorageObject()
+        self.assertRaises(TypeError, setattr, obj, 'count', 'text')
+        self.assertEqual(obj.count, 0)
+
+    def testInvalidDeclarations(self):
+        self.assertRaises(TypeError, Property, int, lambda self: 0, storage=True)
+        self.assertRaises(TypeError, Property, int, constant=True, storage=True)
+        self.assertRaises(TypeError, Property, QObject, storage=True)
+
+
+if __name__ == '__main__':
+    unittest.main()
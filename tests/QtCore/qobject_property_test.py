@@ -37,6 +37,25 @@ class PropertyWithNotify(unittest.TestCase):
         self.assertEqual(o.myProperty, 10)
         self.assertEqual(o.property("myProperty"), 10)
 
+    def testDeletedClassProperty(self):
+        class Deleted(QObject):
+            def __init__(self):
+                QObject.__init__(self)
+                self.v = 0
+            def readV(self):
+                return self.v
+            def writeV(self, v):
+                self.v = v
+            vProperty = Property(int, readV, writeV)
+
+        o = Deleted()
+        o.setProperty("vProperty", 3)
+        del Deleted.vProperty
+        # the metaobject still knows the property and calls it through its own reference
+        o.setProperty("vProperty", 4)
+        self.assertEqual(o.v, 4)
+        self.assertEqual(o.property("vProperty"), 4)
+
 
 if __name__ == '__main__':
     unittest.main()
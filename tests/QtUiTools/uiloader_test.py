@@ -1,5 +1,6 @@
 import unittest
 import os
+import tempfile
 from helper import UsesQApplication
 
 from PySide2.QtWidgets import QWidget
@@ -38,6 +39,38 @@ class QUioaderTeste(UsesQApplication):
         self.assertNotEqual(child, None)
         self.assertEqual(w.findChild(QWidget, "grandson_object"), child.findChild(QWidget, "grandson_object"))
 
+    def testNameAttributes(self):
+        filePath = os.path.join(os.path.dirname(__file__), 'test.ui')
+        loader = QUiLoader()
+        w = loader.load(filePath)
+
+        self.assertTrue(hasattr(w, 'grandson_object'))
+        self.assertEqual(w.child_object, w.findChild(QWidget, "child_object"))
+        self.assertEqual(w.grandson_object, w.findChild(QWidget, "grandson_object"))
+        self.assertTrue(w.child_object is w.child_object)
+        self.assertFalse(hasattr(w, 'missing_object'))
+
+    def testLoadChangedFile(self):
+        with open(os.path.join(os.path.dirname(__file__), 'test.ui')) as source:
+            contents = source.read()
+        fd, filePath = tempfile.mkstemp(suffix='.ui')
+        os.close(fd)
+        try:
+            loader = QUiLoader()
+            with open(filePath, 'w') as ui:
+                ui.write(contents)
+            first = loader.load(filePath)
+            self.assertEqual(loader.load(filePath).grandson_object.text(), 'PushButton')
+
+            with open(filePath, 'w') as ui:
+                ui.write(contents.replace('grandson_object', 'changed_object'))
+            second = loader.load(filePath)
+            self.assertFalse(hasattr(second, 'grandson_object'))
+            self.assertEqual(second.changed_object.text(), 'PushButton')
+            self.assertNotEqual(first.child_object, second.child_object)
+        finally:
+            os.remove(filePath)
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+
+'''Measures how connect and disconnect of distinct Python callbacks scale with
+the number of live connections.'''
+
+from __future__ import print_function
+
+import sys
+import time
+
+from PySide2.QtCore import QObject, Signal
+
+
+class Emitter(QObject):
+    sig = Signal(int)
+
+
+def makeCallbacks(count):
+    return [(lambda value, i=i: i) for i in range(count)]
+
+
+def measure(count):
+    obj = Emitter()
+    callbacks = makeCallbacks(count)
+
+    start = time.time()
+    for callback in callbacks:
+        obj.sig.connect(callback)
+    connectTime = time.time() - start
+
+    start = time.time()
+    for callback in callbacks:
+        obj.sig.disconnect(callback)
+    disconnectTime = time.time() - start
+
+    return connectTime, disconnectTime
+
+
+def main(maxCount):
+    count = 1000
+    while count <= maxCount:
+        connectTime, disconnectTime = measure(count)
+        print('%7d callbacks: connect %6.2f us/op, disconnect %6.2f us/op'
+              % (count, connectTime * 1e6 / count, disconnectTime * 1e6 / count))
+        count *= 10
+
+
+if __name__ == '__main__':
+    main(int(sys.argv[1]) if len(sys.argv) > 1 else 100000)
@@ -0,0 +1,42 @@
+#!/usr/bin/env python
+
+'''Measures the resident memory used by connections of distinct Python lambdas,
+each one of them needs its own global receiver.'''
+
+from __future__ import print_function
+
+import gc
+import resource
+import sys
+
+from PySide2.QtCore import QObject, Signal
+
+
+class Emitter(QObject):
+    sig = Signal(int)
+
+
+def residentMemory():
+    # current resident set size in bytes, read from procfs
+    with open('/proc/self/statm') as statm:
+        pages = int(statm.read().split()[1])
+    return pages * resource.getpagesize()
+
+
+def main(count):
+    obj = Emitter()
+    callbacks = [(lambda value, i=i: i) for i in range(count)]
+    gc.collect()
+
+    before = residentMemory()
+    for callback in callbacks:
+        obj.sig.connect(callback)
+    gc.collect()
+    after = residentMemory()
+
+    print('%d connections: %.1f MiB, %.0f bytes per connection'
+          % (count, (after - before) / 1048576.0, float(after - before) / count))
+
+
+if __name__ == '__main__':
+    main(int(sys.argv[1]) if len(sys.argv) > 1 else 1000000)
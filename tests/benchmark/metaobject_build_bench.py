@@ -0,0 +1,37 @@
+#!/usr/bin/env python
+
+'''Measures the time taken to build the metaobject of Python QObject classes
+declaring 10, 100 and 1000 signals, slots and properties each.'''
+
+from __future__ import print_function
+
+import sys
+import time
+
+from PySide2.QtCore import QObject, Signal, Slot, Property
+
+
+def makeClass(count):
+    attrs = {}
+    for i in range(count):
+        attrs['signal%d' % i] = Signal(int)
+        attrs['slot%d' % i] = Slot(int)(lambda self, value: None)
+        attrs['property%d' % i] = Property(int, lambda self: 0)
+    return type('Members%d' % count, (QObject,), attrs)
+
+
+def measure(count, repeat):
+    start = time.time()
+    for i in range(repeat):
+        cls = makeClass(count)
+        cls().metaObject().methodCount()
+    return (time.time() - start) / repeat
+
+
+def main(repeat):
+    for count in (10, 100, 1000):
+        print('%5d members: %8.2f ms per class' % (count, measure(count, repeat) * 1e3))
+
+
+if __name__ == '__main__':
+    main(int(sys.argv[1]) if len(sys.argv) > 1 else 5)
@@ -0,0 +1,53 @@
+#!/usr/bin/env python
+
+'''Measures the exit time of a process holding 10^4, 10^5 and 10^6 QObject
+wrappers owned by Python, with the default shutdown and with the fast one
+enabled by PYSIDE_FAST_SHUTDOWN=1. Each case runs in its own interpreter.
+
+The exit is split in the PySide cleanup run at exit (the visit of every
+wrapper, the destruction of the QObjects in default mode and the deletion
+of the QCoreApplication), timed by atexit handlers registered before and
+after PySide2, and the rest of the interpreter finalization, which still
+deallocates every wrapper one by one in both modes.'''
+
+from __future__ import print_function
+
+import os
+import subprocess
+import sys
+import time
+
+CHILD = '''
+import atexit, sys, time
+def report(stage):
+    sys.stdout.write('%%s %%r\\n' %% (stage, time.time()))
+    sys.stdout.flush()
+atexit.register(report, 'cleanupEnd')
+from PySide2.QtCore import QCoreApplication, QObject
+atexit.register(report, 'cleanupStart')
+app = QCoreApplication([])
+objects = [QObject() for i in range(%d)]
+report('scriptEnd')
+'''
+
+
+def measure(count, fast):
+    env = dict(os.environ)
+    env['PYSIDE_FAST_SHUTDOWN'] = '1' if fast else '0'
+    child = subprocess.Popen([sys.executable, '-c', CHILD % count], env=env, stdout=subprocess.PIPE)
+    stages = dict((name, float(value)) for name, value in (line.split() for line in child.stdout.read().decode().splitlines()))
+    child.wait()
+    end = time.time()
+    return stages['cleanupEnd'] - stages['cleanupStart'], end - stages['cleanupEnd'], end - stages['scriptEnd']
+
+
+def main():
+    for count in (10000, 100000, 1000000):
+        for fast in (False, True):
+            cleanup, finalization, total = measure(count, fast)
+            print('%8d wrappers, %s: cleanup %8.2f ms, finalization %8.2f ms, exit %8.2f ms'
+                  % (count, 'fast   ' if fast else 'default', cleanup * 1e3, finalization * 1e3, total * 1e3))
+
+
+if __name__ == '__main__':
+    main()
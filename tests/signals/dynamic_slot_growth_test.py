@@ -0,0 +1,36 @@
+#!/usr/bin/env python
+
+'''Test cases for objects gaining many dynamic slots and signals'''
+
+import unittest
+
+from PySide2.QtCore import QObject, SIGNAL, SLOT
+
+
+class Receiver(QObject):
+    def __init__(self, count):
+        QObject.__init__(self)
+        self.received = []
+        for i in range(count):
+            setattr(self, 'slot%d' % i, self.makeSlot(i))
+
+    def makeSlot(self, i):
+        return lambda *args: self.received.append((i,) + args)
+
+
+class DynamicSlotGrowthTest(unittest.TestCase):
+
+    def testManySlots(self):
+        sender = QObject()
+        receiver = Receiver(200)
+        for i in range(200):
+            self.assertTrue(QObject.connect(sender, SIGNAL('value(int)'), receiver, SLOT('slot%d(int)' % i)))
+        sender.emit(SIGNAL('value(int)'), 3)
+        self.assertEqual(sorted(receiver.received), [(i, 3) for i in range(200)])
+        metaObject = receiver.metaObject()
+        for i in range(200):
+            self.assertNotEqual(metaObject.indexOfSlot('slot%d(int)' % i), -1)
+
+
+if __name__ == '__main__':
+    unittest.main()
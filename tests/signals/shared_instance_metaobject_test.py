@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+
+'''Test cases for dynamic signals and slots registered on instances of the same class'''
+
+import unittest
+
+from PySide2.QtCore import QObject, SIGNAL, SLOT
+
+
+class Obj(QObject):
+    def __init__(self):
+        QObject.__init__(self)
+        self.values = []
+
+    def store(self, value):
+        self.values.append(value)
+
+
+def connectDynamic(obj):
+    return QObject.connect(obj, SIGNAL('dynamic(int)'), obj, SLOT('store(int)'))
+
+
+class SharedInstanceMetaObjectTest(unittest.TestCase):
+
+    def testSameMethods(self):
+        objs = [Obj() for i in range(10)]
+        for obj in objs:
+            self.assertTrue(connectDynamic(obj))
+        for i, obj in enumerate(objs):
+            obj.emit(SIGNAL('dynamic(int)'), i)
+        self.assertEqual([obj.values for obj in objs], [[i] for i in range(10)])
+        indexes = set(obj.metaObject().indexOfSignal('dynamic(int)') for obj in objs)
+        self.assertEqual(len(indexes), 1)
+        self.assertNotEqual(indexes.pop(), -1)
+
+    def testDivergingInstance(self):
+        obj1 = Obj()
+        obj2 = Obj()
+        connectDynamic(obj1)
+        connectDynamic(obj2)
+        self.assertTrue(QObject.connect(obj2, SIGNAL('other(int)'), obj2, SLOT('store(int)')))
+        self.assertEqual(obj1.metaObject().indexOfSignal('other(int)'), -1)
+        self.assertNotEqual(obj2.metaObject().indexOfSignal('other(int)'), -1)
+        self.assertEqual(Obj().metaObject().indexOfSignal('dynamic(int)'), -1)
+
+        obj1.emit(SIGNAL('dynamic(int)'), 1)
+        obj2.emit(SIGNAL('other(int)'), 2)
+        self.assertEqual(obj1.values, [1])
+        self.assertEqual(obj2.values, [2])
+
+    def testInstancesDeleted(self):
+        for i in range(3):
+            obj = Obj()
+            connectDynamic(obj)
+            obj.emit(SIGNAL('dynamic(int)'), i)
+            self.assertEqual(obj.values, [i])
+            del obj
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+
+'''Test cases for the cached argument converters used when calling Python slots'''
+
+import unittest
+
+from PySide2.QtCore import QObject, Signal, Slot
+
+
+class Emitter(QObject):
+    first = Signal(int)
+    second = Signal(str, float)
+
+
+class Receiver(QObject):
+    def __init__(self):
+        QObject.__init__(self)
+        self.values = []
+
+    @Slot(int)
+    def onFirst(self, value):
+        self.values.append(value)
+
+
+class ArgumentCacheTest(unittest.TestCase):
+
+    def testRepeatedEmission(self):
+        '''Converters are reused on repeated emissions'''
+        emitter = Emitter()
+        receiver = Receiver()
+        emitter.first.connect(receiver.onFirst)
+        for i in range(100):
+            emitter.first.emit(i)
+        self.assertEqual(receiver.values, list(range(100)))
+
+    def testDynamicSlotsAfterRebuild(self):
+        '''Slots added after the first emission use the right converters'''
+        emitter = Emitter()
+        received = []
+        emitter.first.connect(lambda x: received.append(x))
+        emitter.first.emit(1)
+        emitter.second.connect(lambda s, f: received.append((s, f)))
+        emitter.first.emit(2)
+        emitter.second.emit('a', 1.5)
+        self.assertEqual(received, [1, 2, ('a', 1.5)])
+
+
+if __name__ == '__main__':
+    unittest.main()
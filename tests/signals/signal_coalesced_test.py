@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+
+'''Test cases for coalesced connections, which only deliver the last emission'''
+
+import unittest
+
+from PySide2.QtCore import QObject, QTimer, Signal, CoalescedConnection, Qt
+from helper import UsesQCoreApplication
+
+
+class Emitter(QObject):
+    value = Signal(int)
+    pair = Signal(str, int)
+    objectSignal = Signal(QObject)
+
+
+class CoalescedConnectionTest(UsesQCoreApplication):
+
+    def setUp(self):
+        UsesQCoreApplication.setUp(self)
+        self.obj = Emitter()
+        self.received = []
+
+    def testLastValueOnly(self):
+        self.obj.value.connect(self.received.append, type=CoalescedConnection)
+        for i in range(100):
+            self.obj.value.emit(i)
+        self.assertEqual(self.received, [])
+        self.app.processEvents()
+        self.assertEqual(self.received, [99])
+        self.app.processEvents()
+        self.assertEqual(self.received, [99])
+
+    def testTruncatedCallback(self):
+        self.obj.pair.connect(lambda text: self.received.append(text), type=CoalescedConnection)
+        self.obj.pair.emit('first', 1)
+        self.obj.pair.emit('second', 2)
+        self.app.processEvents()
+        self.assertEqual(self.received, ['second'])
+
+    def testInterval(self):
+        self.obj.value.connect(self.received.append, type=CoalescedConnection, interval=50)
+        self.obj.value.emit(1)
+        self.app.processEvents()
+        self.obj.value.emit(2)
+        self.obj.value.emit(3)
+        self.app.processEvents()
+        self.assertEqual(self.received, [1])
+        QTimer.singleShot(200, self.app.quit)
+        self.app.exec_()
+        self.assertEqual(self.received, [1, 3])
+
+    def testDisconnect(self):
+        self.obj.value.connect(self.received.append, type=CoalescedConnection)
+        self.obj.value.emit(1)
+        self.obj.value.disconnect(self.received.append)
+        self.app.processEvents()
+        self.assertEqual(self.received, [])
+
+    def testObjectArgument(self):
+        self.obj.objectSignal.connect(self.received.append, type=CoalescedConnection)
+        arg = QObject()
+        self.obj.objectSignal.emit(arg)
+        self.app.processEvents()
+        self.assertEqual(self.received, [arg])
+
+    def testDeletedObjectArgument(self):
+        self.obj.objectSignal.connect(self.received.append, type=CoalescedConnection)
+        arg = QObject()
+        self.obj.objectSignal.emit(arg)
+        del arg
+        self.app.processEvents()
+        self.assertEqual(self.received, [None])
+
+    def testIntervalNeedsCoalescedType(self):
+        self.assertRaises(TypeError, self.obj.value.connect, self.received.append,
+                          type=Qt.QueuedConnection, interval=10)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+
+'''Test cases for signals delivered to many Python receivers'''
+
+import unittest
+
+from PySide2.QtCore import QObject, QPoint, Signal, SIGNAL
+
+
+class Emitter(QObject):
+    changed = Signal(str, int)
+    listChanged = Signal(list)
+    pointChanged = Signal(QPoint)
+
+
+class FanOutTest(unittest.TestCase):
+
+    def testManyReceivers(self):
+        obj = Emitter()
+        received = []
+        for i in range(50):
+            obj.changed.connect(lambda s, n, i=i: received.append((i, s, n)))
+        obj.changed.emit('value', 7)
+        self.assertEqual(sorted(received), [(i, 'value', 7) for i in range(50)])
+
+    def testTruncatedReceivers(self):
+        obj = Emitter()
+        received = []
+        obj.changed.connect(lambda: received.append(()))
+        obj.changed.connect(lambda s: received.append((s,)))
+        obj.changed.connect(lambda s, n: received.append((s, n)))
+        obj.changed.connect(lambda s: received.append((s,)))
+        obj.changed.emit('a', 1)
+        self.assertEqual(sorted(received), sorted([(), ('a',), ('a', 1), ('a',)]))
+
+    def testConsecutiveEmissions(self):
+        obj = Emitter()
+        received = []
+        obj.changed.connect(lambda s, n: received.append(n))
+        obj.changed.connect(lambda s, n: received.append(n))
+        for i in range(3):
+            obj.changed.emit('x', i)
+        obj.emit(SIGNAL('changed(QString,int)'), 'y', 3)
+        self.assertEqual(received, [0, 0, 1, 1, 2, 2, 3, 3])
+
+    def testMutableArgumentsNotShared(self):
+        obj = Emitter()
+        received = []
+        def modify(value):
+            received.append(list(value))
+            value.append(0)
+        obj.listChanged.connect(modify)
+        obj.listChanged.connect(modify)
+        obj.listChanged.emit([1, 2])
+        self.assertEqual(received, [[1, 2], [1, 2]])
+
+    def testValueTypeArgumentsNotShared(self):
+        obj = Emitter()
+        received = []
+        def modify(point):
+            received.append(QPoint(point))
+            point.setX(0)
+        obj.pointChanged.connect(modify)
+        obj.pointChanged.connect(modify)
+        obj.pointChanged.emit(QPoint(1, 2))
+        self.assertEqual(received, [QPoint(1, 2), QPoint(1, 2)])
+
+    def testReceiverRemovingSlots(self):
+        # the plans of the receivers are dropped while the emission goes on
+        class Receiver(QObject):
+            def __init__(self):
+                QObject.__init__(self)
+                self.received = []
+            def slot(self, s, n):
+                self.received.append(n)
+                self.destroyed.connect(self.slot)
+        obj = Emitter()
+        receivers = [Receiver() for i in range(3)]
+        for receiver in receivers:
+            obj.changed.connect(receiver.slot)
+        obj.changed.emit('a', 1)
+        self.assertEqual([r.received for r in receivers], [[1], [1], [1]])
+
+
+if __name__ == '__main__':
+    unittest.main()
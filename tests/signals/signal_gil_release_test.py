@@ -0,0 +1,55 @@
+#!/usr/bin/env python
+
+'''Test cases for signals emitted with the GIL released when they only reach C++ code'''
+
+import threading
+import unittest
+
+from PySide2.QtCore import Qt, QObject, QTimer, Signal, SIGNAL
+
+
+class Emitter(QObject):
+    trigger = Signal()
+    relay = Signal(int)
+    value = Signal(int)
+
+
+class GilReleaseTest(unittest.TestCase):
+
+    def testCppReceiver(self):
+        obj = Emitter()
+        timer = QTimer()
+        timer.start(10000)
+        obj.trigger.connect(timer.stop)
+        obj.trigger.emit()
+        self.assertFalse(timer.isActive())
+
+    def testPythonReceiverBehindCppConnection(self):
+        source = Emitter()
+        target = Emitter()
+        received = []
+        QObject.connect(source, SIGNAL('relay(int)'), target, SIGNAL('value(int)'))
+        target.value.connect(received.append)
+        source.relay.emit(5)
+        self.assertEqual(received, [5])
+
+    def testShortCircuit(self):
+        obj = Emitter()
+        received = []
+        obj.emit(SIGNAL('shortCircuit'), 1)
+        obj.connect(SIGNAL('shortCircuit'), lambda value: received.append(value))
+        obj.emit(SIGNAL('shortCircuit'), 2)
+        self.assertEqual(received, [2])
+
+    def testReceiverInOtherThread(self):
+        obj = Emitter()
+        received = []
+        obj.value.connect(received.append, Qt.DirectConnection)
+        thread = threading.Thread(target=obj.value.emit, args=(7,))
+        thread.start()
+        thread.join()
+        self.assertEqual(received, [7])
+
+
+if __name__ == '__main__':
+    unittest.main()
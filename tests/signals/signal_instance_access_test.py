@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+
+'''Test cases for signal instances created on each access of a signal'''
+
+import gc
+import unittest
+import weakref
+
+from PySide2.QtCore import QObject, Signal, SIGNAL
+
+
+class Emitter(QObject):
+    valueChanged = Signal(int)
+    named = Signal((int,), (str,))
+
+
+class SignalInstanceAccessTest(unittest.TestCase):
+
+    def testInstanceDictUntouched(self):
+        obj = Emitter()
+        before = dict(obj.__dict__)
+        obj.valueChanged
+        obj.named[str]
+        obj.destroyed
+        obj.objectNameChanged
+        self.assertEqual(obj.__dict__, before)
+
+    def testConnectThroughDifferentInstances(self):
+        obj = Emitter()
+        received = []
+        obj.valueChanged.connect(received.append)
+        obj.valueChanged.emit(1)
+        obj.named[str].connect(received.append)
+        obj.named[str].emit('a')
+        self.assertEqual(received, [1, 'a'])
+
+        obj.valueChanged.disconnect(received.append)
+        obj.valueChanged.emit(2)
+        self.assertEqual(received, [1, 'a'])
+
+    def testInstanceKeepsSource(self):
+        received = []
+        signal = Emitter().valueChanged
+        signal.connect(received.append)
+        signal.emit(3)
+        self.assertEqual(received, [3])
+
+    def testDynamicSignal(self):
+        obj = QObject()
+        obj.emit(SIGNAL('dynamicSignal(int)'), 0)
+        received = []
+        obj.dynamicSignal.connect(received.append)
+        obj.dynamicSignal.emit(4)
+        self.assertEqual(received, [4])
+        self.assertFalse('dynamicSignal' in obj.__dict__)
+
+    def testInstanceStoredOnSource(self):
+        obj = Emitter()
+        obj.signal = obj.valueChanged
+        obj.dynamic = obj.destroyed
+        ref = weakref.ref(obj)
+        del obj
+        gc.collect()
+        self.assertEqual(ref(), None)
+
+
+if __name__ == '__main__':
+    unittest.main()
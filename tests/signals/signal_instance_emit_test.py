@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+
+'''Test cases for SignalInstance.emit'''
+
+import unittest
+
+from PySide2.QtCore import QObject, Signal
+
+
+class Emitter(QObject):
+    noArgs = Signal()
+    overloaded = Signal((int,), (str,))
+    manyArgs = Signal(int, float, str, bool)
+
+
+class SignalInstanceEmitTest(unittest.TestCase):
+
+    def setUp(self):
+        self.received = []
+
+    def callback(self, *args):
+        self.received.append(args)
+
+    def testPythonSignals(self):
+        obj = Emitter()
+        obj.noArgs.connect(self.callback)
+        obj.manyArgs.connect(self.callback)
+        self.assertTrue(obj.noArgs.emit())
+        self.assertTrue(obj.manyArgs.emit(1, 2.5, 'x', True))
+        self.assertEqual(self.received, [(), (1, 2.5, 'x', True)])
+
+    def testOverloadedSignal(self):
+        obj = Emitter()
+        obj.overloaded.connect(self.callback)
+        obj.overloaded[str].connect(self.callback)
+        obj.overloaded.emit(1)
+        obj.overloaded[str].emit('a')
+        self.assertEqual(self.received, [(1,), ('a',)])
+
+    def testNativeSignal(self):
+        obj = QObject()
+        obj.objectNameChanged.connect(self.callback)
+        obj.objectNameChanged.emit('name')
+        self.assertEqual(self.received, [('name',)])
+
+    def testWrongArguments(self):
+        obj = Emitter()
+        self.assertRaises(TypeError, obj.manyArgs.emit, 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,44 @@
+#!/usr/bin/env python
+
+'''Test cases for QObject.receivers() hiding the connections made by the global receivers'''
+
+import unittest
+
+from PySide2.QtCore import QObject, Signal, SIGNAL
+
+
+class Emitter(QObject):
+    value = Signal(int)
+
+
+class ReceiversCountTest(unittest.TestCase):
+
+    def testDestroyedReceivers(self):
+        obj = Emitter()
+        first = lambda: None
+        second = lambda: None
+        self.assertEqual(obj.receivers(SIGNAL('destroyed()')), 0)
+        obj.value.connect(first)
+        obj.value.connect(second)
+        self.assertEqual(obj.receivers(SIGNAL('destroyed()')), 0)
+        obj.destroyed.connect(first)
+        self.assertEqual(obj.receivers(SIGNAL('destroyed()')), 1)
+        obj.value.disconnect(first)
+        obj.value.disconnect(second)
+        self.assertEqual(obj.receivers(SIGNAL('destroyed()')), 1)
+        obj.destroyed.disconnect(first)
+        self.assertEqual(obj.receivers(SIGNAL('destroyed()')), 0)
+
+    def testReceiverSharedBySenders(self):
+        callback = lambda value: None
+        obj1 = Emitter()
+        obj2 = Emitter()
+        obj1.value.connect(callback)
+        obj2.value.connect(callback)
+        del obj1
+        obj2.destroyed.connect(callback)
+        self.assertEqual(obj2.receivers(SIGNAL('destroyed()')), 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
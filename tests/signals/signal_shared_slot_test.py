@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+
+'''Test cases for Python callbacks sharing the slots of the global receivers'''
+
+import gc
+import unittest
+
+from PySide2.QtCore import QObject, Signal
+
+
+class Emitter(QObject):
+    number = Signal(int)
+    text = Signal(str)
+
+
+class Receiver(object):
+    def __init__(self, received):
+        self.received = received
+
+    def onNumber(self, value):
+        self.received.append(('method', value))
+
+
+class SharedSlotTest(unittest.TestCase):
+
+    def testDisconnectOneOfMany(self):
+        obj = Emitter()
+        received = []
+        first = lambda value: received.append(('first', value))
+        second = lambda value: received.append(('second', value))
+        obj.number.connect(first)
+        obj.number.connect(second)
+        obj.number.disconnect(first)
+        obj.number.emit(1)
+        self.assertEqual(received, [('second', 1)])
+
+    def testDifferentSignatures(self):
+        obj = Emitter()
+        received = []
+        callback = lambda value: received.append(value)
+        obj.number.connect(callback)
+        obj.text.connect(callback)
+        obj.number.emit(2)
+        obj.text.emit('two')
+        obj.number.disconnect(callback)
+        obj.number.emit(3)
+        obj.text.emit('three')
+        self.assertEqual(received, [2, 'two', 'three'])
+
+    def testDeadMethodReceiver(self):
+        obj = Emitter()
+        received = []
+        receiver = Receiver(received)
+        obj.number.connect(receiver.onNumber)
+        obj.number.connect(lambda value: received.append(('lambda', value)))
+        del receiver
+        gc.collect()
+        obj.number.emit(4)
+        self.assertEqual(received, [('lambda', 4)])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+
+'''Test cases for the dispatch of slots implemented by Python classes'''
+
+import unittest
+
+from PySide2.QtCore import QObject, Signal, Slot, SIGNAL, SLOT
+
+
+class Receiver(QObject):
+    def __init__(self):
+        QObject.__init__(self)
+        self.received = []
+
+    @Slot(int)
+    def onValue(self, value):
+        self.received.append(('original', value))
+
+
+class Emitter(QObject):
+    value = Signal(int)
+
+
+class SlotDispatchTest(unittest.TestCase):
+
+    def setUp(self):
+        self.emitter = Emitter()
+        self.receiver = Receiver()
+        self.original = Receiver.onValue
+        QObject.connect(self.emitter, SIGNAL('value(int)'), self.receiver, SLOT('onValue(int)'))
+
+    def tearDown(self):
+        Receiver.onValue = self.original
+
+    def testReplacedClassFunction(self):
+        self.emitter.value.emit(1)
+        Receiver.onValue = lambda self, value: self.received.append(('replaced', value))
+        self.emitter.value.emit(2)
+        self.assertEqual(self.receiver.received, [('original', 1), ('replaced', 2)])
+
+    def testInstanceAttribute(self):
+        received = self.receiver.received
+        self.receiver.onValue = lambda value: received.append(('instance', value))
+        self.emitter.value.emit(3)
+        self.assertEqual(received, [('instance', 3)])
+
+
+if __name__ == '__main__':
+    unittest.main()